@@ -0,0 +1,61 @@
+// Масштабирование broad phase: эталонный перебор пар против сетки, 16..10k шаров,
+// и рядом — решатель контактов (режим по умолчанию). Headless, SFML не нужен.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "Simulation.hpp"
+
+static Simulation makeTable(int count, unsigned seed) {
+    // Площадь стола растёт с числом шаров, пропорции — как у игрового 924x500
+    const float radius = 15.f;
+    float area = count * 4000.f;
+    float w = std::sqrt(area * 924.f / 500.f);
+    float h = area / w;
+    TableGeometry table{0.f, 0.f, w, h, {{0, 0, 17}, {w, 0, 17}, {0, h, 17}, {w, h, 17}}};
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> px(radius, w - radius), py(radius, h - radius);
+    std::uniform_real_distribution<float> pv(-800.f, 800.f);
+    std::vector<BallState> balls;
+    for (int i = 0; i < count; ++i)
+        balls.push_back({px(rng), py(rng), pv(rng), pv(rng), radius, i});
+    return Simulation(table, balls);
+}
+
+// Шары засыпают через ~2300 шагов (половина — к ~1850), а спящий стол меряет
+// пустой тик. Поэтому шаги идут отрезками по kRound, каждый с исходной
+// расстановки; копия стола — вне замера
+static constexpr int kRound = 600;
+
+static double nsPerStep(const Simulation& start, CollisionMode mode, int steps) {
+    double ns = 0.0;
+    for (int done = 0; done < steps; done += kRound) {
+        Simulation sim = start;
+        sim.setCollisionMode(mode);
+        int n = std::min(kRound, steps - done);
+        auto t0 = std::chrono::steady_clock::now();
+        for (int s = 0; s < n; ++s)
+            sim.step();
+        auto t1 = std::chrono::steady_clock::now();
+        ns += std::chrono::duration<double, std::nano>(t1 - t0).count();
+    }
+    return ns / steps;
+}
+
+int main() {
+    std::printf("%8s %16s %16s %10s %20s\n", "balls", "pairwise ns/step", "grid ns/step", "speedup",
+                "contacts ns/step");
+    for (int count : {16, 64, 256, 1024, 4096, 10000}) {
+        Simulation sim = makeTable(count, 12345u);
+        // Перебор пар на 10k шаров — десятки миллионов пар за шаг, шагов делаем меньше
+        int steps = std::max(10, 2000000 / (count * count / 16 + 1));
+        double pairwise = nsPerStep(sim, CollisionMode::Pairwise, steps);
+        double grid = nsPerStep(sim, CollisionMode::Grid, steps);
+        double contacts = nsPerStep(sim, CollisionMode::Contacts, steps);
+        std::printf("%8d %16.0f %16.0f %9.1fx %20.0f\n", count, pairwise, grid, pairwise / grid, contacts);
+    }
+    return 0;
+}
@@ -0,0 +1,74 @@
+// Сукно до первого кадра: старый попиксельный цикл, новый генератор (в один
+// поток и в пуле) и чтение из кэша. Заодно проверяет, что новый генератор
+// даёт те же байты, что и старый цикл; при расхождении возвращает 1.
+//   cloth_bench [width height]
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <vector>
+#include "ClothTexture.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+// Цикл, который раньше стоял в main.cpp: setPixel + gradientColor на каждый пиксель
+static std::vector<std::uint8_t> legacyCloth(unsigned w, unsigned h) {
+    std::vector<std::uint8_t> img(static_cast<std::size_t>(w) * h * 4);
+    float tableW = static_cast<float>(w), tableH = static_cast<float>(h);
+    auto setPixel = [&](unsigned x, unsigned y, const std::uint8_t (&c)[4]) {
+        std::copy(c, c + 4, img.begin() + (static_cast<std::size_t>(y) * w + x) * 4);
+    };
+    const std::uint8_t a[4] = {5, 95, 45, 255}, b[4] = {25, 65, 30, 255};
+    for (unsigned int y = 0; y < h; ++y)
+        for (unsigned int x = 0; x < w; ++x) {
+            float distToCenter = std::abs((int)tableW/2 - (int)x) / (tableW/2);
+            float edgeShadow = std::min({ y / tableH, (tableH-1-y) / tableH, x / tableW, (tableW-1-x) / tableW });
+            float t = 0.25f*distToCenter + 0.6f*edgeShadow;
+            std::uint8_t c[4];
+            for (int k = 0; k < 4; ++k)
+                c[k] = static_cast<std::uint8_t>(a[k] + (b[k] - a[k]) * t);
+            setPixel(x, y, c);
+        }
+    return img;
+}
+
+template <typename F>
+static double bestOf(int runs, F f) {
+    double best = 1e30;
+    for (int r = 0; r < runs; ++r) {
+        auto t0 = Clock::now();
+        f();
+        best = std::min(best, std::chrono::duration<double, std::milli>(Clock::now() - t0).count());
+    }
+    return best;
+}
+
+int main(int argc, char** argv) {
+    ClothParams params;
+    if (argc >= 3) {
+        params.width = static_cast<unsigned>(std::atoi(argv[1]));
+        params.height = static_cast<unsigned>(std::atoi(argv[2]));
+    }
+    WorkStealingPool pool;
+    std::string cacheDir = (std::filesystem::temp_directory_path() / "billiard_cloth_bench").string();
+
+    std::vector<std::uint8_t> legacy, scalar, parallel, cached;
+    double tLegacy = bestOf(5, [&] { legacy = legacyCloth(params.width, params.height); });
+    double tScalar = bestOf(5, [&] { scalar = generateCloth(params); });
+    double tParallel = bestOf(5, [&] { parallel = generateCloth(params, &pool); });
+    saveClothCache(cacheDir, params, parallel);
+    double tCache = bestOf(5, [&] { loadClothCache(cacheDir, params, cached); });
+
+    std::printf("cloth %ux%u, %u threads\n", params.width, params.height, pool.size());
+    std::printf("%-10s %10s\n", "stage", "ms");
+    std::printf("%-10s %10.3f\n", "legacy", tLegacy);
+    std::printf("%-10s %10.3f\n", "generate", tScalar);
+    std::printf("%-10s %10.3f\n", "parallel", tParallel);
+    std::printf("%-10s %10.3f\n", "cache", tCache);
+
+    bool ok = scalar == legacy && parallel == legacy && cached == legacy;
+    std::printf("%s\n", ok ? "pixels match the legacy loop" : "MISMATCH against the legacy loop");
+    return ok ? 0 : 1;
+}
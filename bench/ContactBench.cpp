@@ -0,0 +1,174 @@
+// Решатель контактов (CollisionMode::Contacts) против прежнего удара по парам (Grid):
+//   1) пирамида: сколько шагов она укладывается до удара и разбивается после,
+//      сколько итераций скоростей нужно за подшаг;
+//   2) порядок: тот же стол, шары в BallStore в другом порядке — у Contacts
+//      состояние по номерам шаров должно совпасть побитово;
+//   3) крупные кучки: сотни островов по 28 шаров, время шага на 1..N потоках
+//      и совпадение результата с однопоточным.
+// Headless, SFML не нужен. Код возврата 1, если Contacts зависит от порядка или числа потоков.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+#include "Simulation.hpp"
+#include "TableLayout.hpp"
+#include "WorkStealingPool.hpp"
+
+namespace {
+
+const char* modeName(CollisionMode mode) {
+    return mode == CollisionMode::Contacts ? "contacts" : "grid";
+}
+
+std::vector<BallState> rackBalls() {
+    TableLayout layout;
+    BallStore store;
+    layout.rack(store);
+    std::vector<BallState> balls;
+    for (std::size_t i = 0; i < store.size(); ++i)
+        balls.push_back(store.get(i));
+    return balls;
+}
+
+// Шары по номерам: так сравниваются столы с разным порядком в BallStore
+std::vector<BallState> byNumber(const BallStore& balls) {
+    std::vector<BallState> out;
+    for (std::size_t i = 0; i < balls.size(); ++i)
+        out.push_back(balls.get(i));
+    std::sort(out.begin(), out.end(), [](const BallState& a, const BallState& b) { return a.number < b.number; });
+    return out;
+}
+
+bool sameBits(const std::vector<BallState>& a, const std::vector<BallState>& b) {
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(BallState)) == 0;
+}
+
+struct RackRun {
+    int settleSteps = 0, breakSteps = 0;
+    std::size_t pocketed = 0;
+    double avgIterations = 0.0;
+    int maxIterations = 0;
+};
+
+RackRun rack(CollisionMode mode, float power) {
+    TableLayout layout;
+    Simulation sim(layout.geometry(), rackBalls());
+    sim.setCollisionMode(mode);
+    RackRun run;
+    run.settleSteps = sim.simulateUntilRest();
+    const ContactStats before = sim.contactStats();
+    sim.balls().setVelocity(static_cast<std::size_t>(sim.balls().find(0)), power, 3.f);
+    std::vector<int> pocketed;
+    while (!sim.isAtRest() && run.breakSteps < 240 * 600) {
+        sim.step();
+        ++run.breakSteps;
+        run.maxIterations = std::max(run.maxIterations, sim.contactStats().iterations);
+    }
+    sim.simulateUntilRest(&pocketed);
+    run.pocketed = pocketed.size();
+    const ContactStats& after = sim.contactStats();
+    if (after.solves > before.solves)
+        run.avgIterations = double(after.totalIterations - before.totalIterations) / (after.solves - before.solves);
+    return run;
+}
+
+// Тот же разбой, шары добавлены в обратном порядке
+bool orderIndependent(CollisionMode mode, int steps) {
+    TableLayout layout;
+    std::vector<BallState> balls = rackBalls();
+    balls.front().vx = 1600.f;
+    balls.front().vy = 3.f;
+    std::vector<BallState> reversed(balls.rbegin(), balls.rend());
+    Simulation a(layout.geometry(), balls), b(layout.geometry(), reversed);
+    a.setCollisionMode(mode);
+    b.setCollisionMode(mode);
+    for (int s = 0; s < steps; ++s) {
+        a.step();
+        b.step();
+    }
+    return sameBits(byNumber(a.balls()), byNumber(b.balls()));
+}
+
+// Треугольники по 28 шаров с лёгким перекрытием и битком, летящим в вершину
+Simulation clusters(int count) {
+    const float radius = 10.f, spacing = 2.f * radius * 0.98f;
+    const float cell = 14 * spacing;
+    int cols = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(count))));
+    int rows = (count + cols - 1) / cols;
+    float w = cols * cell, h = rows * cell;
+    TableGeometry table{0.f, 0.f, w, h, {{0, 0, 12}, {w, 0, 12}, {0, h, 12}, {w, h, 12}}};
+    std::vector<BallState> balls;
+    int number = 0;
+    for (int k = 0; k < count; ++k) {
+        float cx = (k % cols) * cell + cell * 0.35f, cy = (k / cols) * cell + cell * 0.5f;
+        balls.push_back({cx - cell * 0.25f, cy, 900.f, 0.f, radius, number++});
+        for (int row = 0; row < 7; ++row)
+            for (int col = 0; col <= row; ++col)
+                balls.push_back({cx + row * spacing * 0.8660254f, cy + (col - row / 2.f) * spacing, 0.f, 0.f,
+                                 radius, number++});
+    }
+    return Simulation(table, balls);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int clusterCount = argc > 1 ? std::max(1, std::atoi(argv[1])) : 256;
+    int failures = 0;
+
+    std::printf("break (cue at 800 and 1600 px/s)\n");
+    std::printf("%-9s %6s %8s %8s %9s %9s %9s\n", "mode", "power", "settle", "break", "pocketed", "avg it", "max it");
+    for (float power : {800.f, 1600.f})
+        for (CollisionMode mode : {CollisionMode::Grid, CollisionMode::Contacts}) {
+            RackRun r = rack(mode, power);
+            std::printf("%-9s %6.0f %8d %8d %9zu %9.2f %9d\n", modeName(mode), power, r.settleSteps, r.breakSteps,
+                        r.pocketed, r.avgIterations, r.maxIterations);
+        }
+
+    std::printf("\nsame break, balls added in reverse order (240 steps)\n");
+    for (CollisionMode mode : {CollisionMode::Grid, CollisionMode::Contacts}) {
+        bool same = orderIndependent(mode, 240);
+        std::printf("%-9s %s\n", modeName(mode), same ? "identical" : "differs");
+        failures += mode == CollisionMode::Contacts && !same;
+    }
+
+    const int steps = 240;
+    Simulation base = clusters(clusterCount);
+    std::printf("\n%d clusters, %zu balls, %d steps\n", clusterCount, base.balls().size(), steps);
+    std::printf("%8s %12s %9s %10s %9s\n", "threads", "us/step", "speedup", "islands", "result");
+    std::vector<BallState> reference;
+    double serial = 0.0;
+    const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned> threadCounts;
+    for (unsigned t = 1; t < hw; t *= 2)
+        threadCounts.push_back(t);
+    threadCounts.push_back(hw);
+    for (unsigned threads : threadCounts) {
+        WorkStealingPool pool(threads);
+        Simulation sim = base;
+        sim.setContactPool(threads > 1 ? &pool : nullptr);
+        std::size_t islands = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        for (int s = 0; s < steps; ++s) {
+            sim.step();
+            islands = std::max(islands, sim.contactStats().islands);
+        }
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / steps;
+        std::vector<BallState> state = byNumber(sim.balls());
+        bool same = true;
+        if (threads == 1) {
+            reference = state;
+            serial = us;
+        } else {
+            same = sameBits(reference, state);
+            failures += !same;
+        }
+        std::printf("%8u %12.1f %8.2fx %10zu %9s\n", threads, us, serial / us, islands, same ? "same" : "DIFFERS");
+    }
+    return failures ? 1 : 0;
+}
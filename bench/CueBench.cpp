@@ -0,0 +1,99 @@
+// Кадр прицеливания: старый кий (новый sf::RenderTexture на каждый кадр)
+// против Cue с градиентом по вершинам. Рисуем во внеэкранный буфер размером
+// с окно и меряем время кадра: mean / p99 / max, мс, и во сколько раз старый
+// кий медленнее. Нужен GL-контекст, без него create() не пройдёт.
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "Cue.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+// Так рисовал кий main.cpp до перехода на Cue
+static void drawLegacyCue(sf::RenderTarget& target, sf::Vector2f start, sf::Vector2f end, float cueLen) {
+    float angle = std::atan2(end.y - start.y, end.x - start.x) * 180.f / 3.1415926f;
+    sf::RectangleShape cueShadow(sf::Vector2f(cueLen, 6.f));
+    cueShadow.setOrigin(0.f, 3.f);
+    cueShadow.setPosition(start.x + 3.f, start.y + 5.f);
+    cueShadow.setRotation(angle);
+    cueShadow.setFillColor(sf::Color(25, 30, 20, 60));
+    target.draw(cueShadow);
+    sf::RectangleShape cueStick(sf::Vector2f(cueLen, 6.f));
+    cueStick.setOrigin(0.f, 3.f);
+    cueStick.setPosition(start);
+    cueStick.setRotation(angle);
+    sf::VertexArray gradient(sf::TrianglesStrip, 4);
+    gradient[0].position = sf::Vector2f(0.f, 0.f);
+    gradient[1].position = sf::Vector2f(0.f, 6.f);
+    gradient[2].position = sf::Vector2f(cueLen, 0.f);
+    gradient[3].position = sf::Vector2f(cueLen, 6.f);
+    gradient[0].color = gradient[1].color = sf::Color(210, 170, 80);
+    gradient[2].color = gradient[3].color = sf::Color(110, 65, 20);
+    sf::RenderTexture cueTex;
+    cueTex.create(static_cast<unsigned int>(cueLen), 6);
+    cueTex.clear(sf::Color::Transparent);
+    cueTex.draw(gradient);
+    cueTex.display();
+    cueStick.setTexture(&cueTex.getTexture());
+    target.draw(cueStick);
+    sf::RectangleShape tip(sf::Vector2f(11.f, 6.f));
+    tip.setOrigin(11.f, 3.f);
+    tip.setPosition(end);
+    tip.setRotation(angle);
+    tip.setFillColor(sf::Color(62, 38, 20));
+    target.draw(tip);
+}
+
+struct FrameTimes {
+    double mean, p99, max;
+};
+
+template <typename DrawCue>
+static FrameTimes run(const char* name, sf::RenderTexture& frame, int frames, DrawCue drawCue) {
+    std::vector<double> ms;
+    ms.reserve(frames);
+    sf::Vector2f start(300.f, 300.f);
+    for (int f = 0; f < frames; ++f) {
+        // Игрок водит мышью: угол и длина меняются каждый кадр
+        float a = f * 0.05f;
+        float len = 10.f + 210.f * (0.5f + 0.5f * std::sin(f * 0.03f));
+        sf::Vector2f end = start + sf::Vector2f(std::cos(a), std::sin(a)) * len;
+
+        auto t0 = Clock::now();
+        frame.clear(sf::Color(24, 40, 26));
+        drawCue(frame, start, end, len);
+        frame.display();
+        ms.push_back(std::chrono::duration<double, std::milli>(Clock::now() - t0).count());
+    }
+    double sum = 0;
+    for (double x : ms)
+        sum += x;
+    std::sort(ms.begin(), ms.end());
+    FrameTimes t{sum / ms.size(), ms[static_cast<std::size_t>(0.99 * (ms.size() - 1))], ms.back()};
+    std::printf("%-8s %8d %10.3f %10.3f %10.3f\n", name, frames, t.mean, t.p99, t.max);
+    return t;
+}
+
+int main() {
+    sf::RenderTexture frame;
+    if (!frame.create(1024, 600)) {
+        std::fprintf(stderr, "cue_bench: cannot create a 1024x600 render texture (no GL context?)\n");
+        return 1;
+    }
+
+    const int frames = 2000;
+    std::printf("%-8s %8s %10s %10s %10s\n", "cue", "frames", "mean ms", "p99 ms", "max ms");
+    FrameTimes legacy = run("legacy", frame, frames, drawLegacyCue);
+    Cue cue;
+    FrameTimes vertex = run("vertex", frame, frames, [&](sf::RenderTarget& target, sf::Vector2f start, sf::Vector2f end, float len) {
+        cue.update(start, end, len, true);
+        cue.draw(target);
+    });
+    // Пик кадра прицеливания — это p99 и max, среднее его почти не видит
+    std::printf("legacy/vertex: mean %.2fx, p99 %.2fx, max %.2fx\n", legacy.mean / vertex.mean,
+                legacy.p99 / vertex.p99, legacy.max / vertex.max);
+    return 0;
+}
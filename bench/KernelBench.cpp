@@ -0,0 +1,93 @@
+// Ядра интегрирования: проверка побитового совпадения SIMD-вариантов со скалярным
+// и замер ns/шар. Возвращает 1, если хоть одно ядро разошлось со скалярным.
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "IntegrateKernel.hpp"
+#include "Simulation.hpp"
+
+static const TableGeometry kTable{50, 50, 924, 500, {
+    {50, 50, 17}, {512, 50, 17}, {974, 50, 17},
+    {50, 550, 17}, {512, 550, 17}, {974, 550, 17}}};
+
+static IntegrateParams makeParams() {
+    float dt = Simulation::kFixedDt;
+    return {dt, Simulation::kMu * Simulation::kGravity * dt, Simulation::kCushion,
+            kTable.left, kTable.top, kTable.left + kTable.width, kTable.top + kTable.height,
+            kTable.pockets.data(), kTable.pockets.size(), Simulation::kPocketMargin};
+}
+
+// Случайные шары, в том числе стоящие, медленнее decel, у луз и за бортами
+static BallStore makeBalls(std::size_t count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> px(20.f, 1004.f), py(20.f, 580.f);
+    std::uniform_real_distribution<float> pv(-1600.f, 1600.f), slow(-0.06f, 0.06f);
+    std::uniform_int_distribution<int> kind(0, 9);
+    BallStore balls;
+    for (std::size_t i = 0; i < count; ++i) {
+        BallState b{px(rng), py(rng), pv(rng), pv(rng), 15.f, static_cast<int>(i)};
+        switch (kind(rng)) {
+        case 0: b.vx = b.vy = 0.f; break;
+        case 1: b.vx = slow(rng); b.vy = slow(rng); break;
+        case 2: b.x = kTable.pockets[i % 6].x + 5.f; b.y = kTable.pockets[i % 6].y + 5.f; break;
+        default: break;
+        }
+        balls.push(b);
+    }
+    return balls;
+}
+
+static bool sameBits(const std::vector<float>& a, const std::vector<float>& b) {
+    return std::memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0;
+}
+
+int main() {
+    std::vector<IntegrateKernel> kernels = {&integrateScalar};
+#if defined(__x86_64__) || defined(__i386__)
+    kernels.push_back(&integrateSse);
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        kernels.push_back(&integrateAvx2);
+#endif
+    const IntegrateParams params = makeParams();
+    std::printf("dispatch: %s\n", integrateKernelName(selectIntegrateKernel()));
+
+    bool ok = true;
+    for (std::size_t count : {1u, 7u, 8u, 13u, 16u, 1000u, 4099u}) {
+        BallStore reference = makeBalls(count, 777u + static_cast<unsigned>(count));
+        std::vector<BallStore> states(kernels.size(), reference);
+        for (int step = 0; step < 2000; ++step)
+            for (std::size_t k = 0; k < kernels.size(); ++k)
+                kernels[k](states[k], params);
+        for (std::size_t k = 1; k < kernels.size(); ++k) {
+            bool same = sameBits(states[0].x, states[k].x) && sameBits(states[0].y, states[k].y) &&
+                        sameBits(states[0].vx, states[k].vx) && sameBits(states[0].vy, states[k].vy);
+            if (!same) {
+                std::printf("MISMATCH: %s vs scalar, %zu balls\n", integrateKernelName(kernels[k]), count);
+                ok = false;
+            }
+        }
+    }
+    std::printf("bit-for-bit agreement: %s\n", ok ? "ok" : "FAILED");
+
+    std::printf("%8s", "balls");
+    for (auto k : kernels)
+        std::printf(" %10s", integrateKernelName(k));
+    std::printf("   (ns/ball/step)\n");
+    for (std::size_t count : {16u, 1024u, 100000u}) {
+        std::printf("%8zu", count);
+        for (auto kernel : kernels) {
+            BallStore balls = makeBalls(count, 1u);
+            int steps = static_cast<int>(20000000 / count) + 1;
+            auto t0 = std::chrono::steady_clock::now();
+            for (int s = 0; s < steps; ++s)
+                kernel(balls, params);
+            auto t1 = std::chrono::steady_clock::now();
+            std::printf(" %10.2f", std::chrono::duration<double, std::nano>(t1 - t0).count() / steps / count);
+        }
+        std::printf("\n");
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,200 @@
+// Набор воспроизводимых сценариев: стоимость шага физики, шаги до остановки,
+// разбор событий луз на стороне игры и подготовка кадра к отрисовке — отдельно.
+// Сама проверка луз входит в шаг физики.
+// Результат — JSON, который удобно сравнивать между коммитами:
+//   physics_bench [--json out.json] [--label <commit>]
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "IntegrateKernel.hpp"
+#include "Simulation.hpp"
+#include "TableLayout.hpp"
+#include "TableRenderer.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+struct Scenario {
+    std::string name;
+    Simulation sim;
+    int maxSteps;
+    bool stopAtRest = true;
+};
+
+struct Result {
+    std::string name;
+    std::size_t balls = 0;
+    int steps = 0;
+    bool reachedRest = false;
+    std::size_t pocketed = 0;
+    double substeps = 0;    // в среднем на шаг
+    double stepMean = 0, stepP50 = 0, stepP99 = 0;
+    double pocketMean = 0;
+    double renderMean = 0;
+};
+
+static double ns(Clock::time_point a, Clock::time_point b) {
+    return std::chrono::duration<double, std::nano>(b - a).count();
+}
+
+static double percentile(std::vector<double> v, double q) {
+    if (v.empty())
+        return 0.0;
+    std::size_t k = static_cast<std::size_t>(q * (v.size() - 1));
+    std::nth_element(v.begin(), v.begin() + k, v.end());
+    return v[k];
+}
+
+// Та же работа, что делает main.cpp перед отрисовкой шаров: тени и шары в общий пакет
+static void prepareFrame(const BallStore& balls, TableRenderer& renderer) {
+    renderer.beginFrame();
+    for (std::size_t i = 0; i < balls.size(); ++i)
+        renderer.addShadow({balls.x[i], balls.y[i]}, balls.radius[i]);
+    for (std::size_t i = 0; i < balls.size(); ++i)
+        renderer.addBall({balls.x[i], balls.y[i]}, balls.radius[i], balls.number[i] % 16);
+}
+
+static Result run(Scenario& sc) {
+    Result r;
+    r.name = sc.name;
+    r.balls = sc.sim.balls().size();
+
+    std::vector<double> stepNs, pocketNs, renderNs;
+    std::vector<int> pocketed;
+    std::vector<Ball> looks;
+    for (int k = 0; k < 16; ++k)
+        looks.emplace_back(TableLayout{}.ballRadius, sf::Color::White, k);
+    BallAtlas atlas(looks);
+    TableRenderer renderer(TableLayout{}, atlas, 24.f, 8.f);
+    stepNs.reserve(sc.maxSteps);
+
+    const int stepsPerFrame = static_cast<int>(1.f / (60.f * Simulation::kFixedDt));
+    for (int s = 0; s < sc.maxSteps; ++s) {
+        auto t0 = Clock::now();
+        sc.sim.step();
+        auto t1 = Clock::now();
+        for (const auto& e : sc.sim.pocketEvents())
+            pocketed.push_back(e.number);
+        sc.sim.clearPocketEvents();
+        auto t2 = Clock::now();
+        stepNs.push_back(ns(t0, t1));
+        pocketNs.push_back(ns(t1, t2));
+
+        if (s % stepsPerFrame == 0) {
+            auto t3 = Clock::now();
+            prepareFrame(sc.sim.balls(), renderer);
+            renderNs.push_back(ns(t3, Clock::now()));
+        }
+        ++r.steps;
+        r.reachedRest = sc.sim.isAtRest();
+        if (sc.stopAtRest && r.reachedRest)
+            break;
+    }
+
+    auto mean = [](const std::vector<double>& v) {
+        double sum = 0;
+        for (double x : v)
+            sum += x;
+        return v.empty() ? 0.0 : sum / v.size();
+    };
+    r.pocketed = pocketed.size();
+    r.substeps = r.steps ? static_cast<double>(sc.sim.substeps()) / r.steps : 0.0;
+    r.stepMean = mean(stepNs);
+    r.stepP50 = percentile(stepNs, 0.5);
+    r.stepP99 = percentile(stepNs, 0.99);
+    r.pocketMean = mean(pocketNs);
+    r.renderMean = mean(renderNs);
+    return r;
+}
+
+static Simulation randomTable(int count, unsigned seed, float maxSpeed) {
+    // Площадь растёт с числом шаров, пропорции — как у игрового стола
+    float area = count * 4000.f;
+    float w = std::sqrt(area * 924.f / 500.f);
+    TableLayout layout{0.f, 0.f, w, area / w};
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> px(layout.ballRadius, layout.width - layout.ballRadius);
+    std::uniform_real_distribution<float> py(layout.ballRadius, layout.height - layout.ballRadius);
+    std::uniform_real_distribution<float> pv(-maxSpeed, maxSpeed);
+    std::vector<BallState> balls;
+    for (int i = 0; i < count; ++i)
+        balls.push_back({px(rng), py(rng), pv(rng), pv(rng), layout.ballRadius, i});
+    return Simulation(layout.geometry(), balls);
+}
+
+static std::vector<Scenario> makeScenarios() {
+    TableLayout layout;
+    std::vector<Scenario> list;
+
+    Simulation brk(layout.geometry());
+    layout.rack(brk.balls());
+    brk.balls().setVelocity(0, 1600.f, 3.f);    // в лоб по пирамиде с максимальной силой
+    list.push_back({"break_15", brk, 240 * 120});
+
+    // Вчетверо сильнее: первые шаги дробятся на подшаги (Simulation::kMaxTravel)
+    Simulation hard(layout.geometry());
+    layout.rack(hard.balls());
+    hard.balls().setVelocity(0, 6400.f, 12.f);
+    list.push_back({"power_break", hard, 240 * 120});
+
+    Simulation rack(layout.geometry());
+    layout.rack(rack.balls());
+    list.push_back({"rack_at_rest", rack, 2000, false});
+
+    list.push_back({"random_1k", randomTable(1000, 1u, 800.f), 600});
+    list.push_back({"random_10k", randomTable(10000, 2u, 800.f), 60});
+
+    Simulation roll(layout.geometry(), {{layout.x + 100.f, layout.y + 130.f, 1500.f, 420.f, layout.ballRadius, 0}});
+    list.push_back({"long_roll", roll, 240 * 300});
+    return list;
+}
+
+int main(int argc, char** argv) {
+    const char* jsonPath = nullptr;
+    std::string label = "local";
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--json") == 0)
+            jsonPath = argv[++i];
+        else if (std::strcmp(argv[i], "--label") == 0)
+            label = argv[++i];
+    }
+
+    std::vector<Result> results;
+    for (auto& sc : makeScenarios())
+        results.push_back(run(sc));
+
+    std::printf("kernel: %s\n", integrateKernelName(selectIntegrateKernel()));
+    std::printf("%-14s %6s %7s %5s %6s %12s %12s %12s %12s %12s\n", "scenario", "balls", "steps", "rest",
+                "sub", "step ns", "p50 ns", "p99 ns", "pocket ns", "render ns");
+    for (const auto& r : results)
+        std::printf("%-14s %6zu %7d %5s %6.2f %12.0f %12.0f %12.0f %12.0f %12.0f\n", r.name.c_str(), r.balls, r.steps,
+                    r.reachedRest ? "yes" : "no", r.substeps, r.stepMean, r.stepP50, r.stepP99, r.pocketMean, r.renderMean);
+
+    if (jsonPath) {
+        FILE* f = std::fopen(jsonPath, "w");
+        if (!f) {
+            std::perror(jsonPath);
+            return 1;
+        }
+        std::fprintf(f, "{\n  \"label\": \"%s\",\n  \"kernel\": \"%s\",\n  \"scenarios\": [\n", label.c_str(),
+                     integrateKernelName(selectIntegrateKernel()));
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const auto& r = results[i];
+            std::fprintf(f,
+                "    {\"name\": \"%s\", \"balls\": %zu, \"steps\": %d, \"reached_rest\": %s, \"pocketed\": %zu, \"substeps_per_step\": %.3f, "
+                "\"step_ns_mean\": %.1f, \"step_ns_p50\": %.1f, \"step_ns_p99\": %.1f, "
+                "\"pocket_check_ns_mean\": %.1f, \"render_prep_ns_mean\": %.1f}%s\n",
+                r.name.c_str(), r.balls, r.steps, r.reachedRest ? "true" : "false", r.pocketed, r.substeps,
+                r.stepMean, r.stepP50, r.stepP99, r.pocketMean, r.renderMean,
+                i + 1 < results.size() ? "," : "");
+        }
+        std::fprintf(f, "  ]\n}\n");
+        std::fclose(f);
+    }
+    return 0;
+}
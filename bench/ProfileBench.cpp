@@ -0,0 +1,149 @@
+// Профили физики: шаг, специализированный под константы профиля (setProfile),
+// против общего шага с параметрами в памяти (setParams) на тех же сценах,
+// и отдельно — одно интегрирование: ядра профиля против общих с теми же
+// инструкциями (весь стол SIMD-ядром и каждый восьмой шар поштучно).
+// Результаты обоих должны совпадать побитово; иначе код возврата 1.
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "Simulation.hpp"
+#include "TableLayout.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+struct Scene {
+    const char* name;
+    Simulation sim;
+    int steps;
+};
+
+static Simulation randomTable(int count, unsigned seed, float maxSpeed) {
+    float area = count * 4000.f;
+    float w = std::sqrt(area * 924.f / 500.f);
+    TableLayout layout{0.f, 0.f, w, area / w};
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> px(layout.ballRadius, layout.width - layout.ballRadius);
+    std::uniform_real_distribution<float> py(layout.ballRadius, layout.height - layout.ballRadius);
+    std::uniform_real_distribution<float> pv(-maxSpeed, maxSpeed);
+    std::vector<BallState> balls;
+    for (int i = 0; i < count; ++i)
+        balls.push_back({px(rng), py(rng), pv(rng), pv(rng), layout.ballRadius, i});
+    return Simulation(layout.geometry(), balls);
+}
+
+static std::vector<Scene> makeScenes() {
+    TableLayout layout;
+    Simulation brk(layout.geometry());
+    layout.rack(brk.balls());
+    brk.balls().setVelocity(0, 1600.f, 3.f);
+    return {
+        {"break_15", brk, 240 * 20},
+        {"random_1k", randomTable(1000, 1u, 800.f), 600},
+    };
+}
+
+// Лучшее из нескольких прогонов, нс на шаг; hash — состояние после прогона
+static double timeSteps(const Simulation& start, int steps, std::uint64_t& hash) {
+    double best = 1e30;
+    for (int rep = 0; rep < 5; ++rep) {
+        Simulation sim = start;
+        auto t0 = Clock::now();
+        for (int s = 0; s < steps; ++s)
+            sim.step();
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / steps;
+        best = std::min(best, ns);
+        hash = sim.stateHash();
+    }
+    return best;
+}
+
+static bool sameBalls(const BallStore& a, const BallStore& b) {
+    std::size_t bytes = a.size() * sizeof(float);
+    return a.size() == b.size() && std::memcmp(a.x.data(), b.x.data(), bytes) == 0 &&
+           std::memcmp(a.y.data(), b.y.data(), bytes) == 0 && std::memcmp(a.vx.data(), b.vx.data(), bytes) == 0 &&
+           std::memcmp(a.vy.data(), b.vy.data(), bytes) == 0;
+}
+
+// Лучшее из нескольких прогонов, нс на подшаг; out — шары после прогона
+template <class Run>
+static double timeIntegrate(const BallStore& start, int substeps, BallStore& out, Run run) {
+    double best = 1e30;
+    for (int rep = 0; rep < 5; ++rep) {
+        out = start;
+        auto t0 = Clock::now();
+        for (int s = 0; s < substeps; ++s)
+            run(out);
+        best = std::min(best, std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / substeps);
+    }
+    return best;
+}
+
+static int kernelTable() {
+    const int substeps = 2000;
+    Simulation table = randomTable(1000, 2u, 800.f);
+    const BallStore& start = table.balls();
+    const TableGeometry& g = table.table();
+    std::vector<std::uint32_t> sparse;
+    for (std::uint32_t i = 0; i < start.size(); i += 8)
+        sparse.push_back(i);
+    const IntegrateKernel isa = selectIntegrateKernel();
+    const IntegrateKernelSet& generic = genericIntegrateKernels();
+
+    int mismatches = 0;
+    std::printf("\nintegrate only, 1000 balls, %s kernels (ns/substep)\n", integrateKernelName(isa));
+    std::printf("%-10s %-8s %14s %16s %8s %6s\n", "profile", "path", "fixed", "generic", "speedup", "same");
+    for (const PhysicsProfileInfo& profile : physicsProfiles()) {
+        const PhysicsParams& pp = profile.params;
+        IntegrateParams params{Simulation::kFixedDt, pp.mu * pp.gravity * Simulation::kFixedDt, pp.cushion,
+                               g.left, g.top, g.left + g.width, g.top + g.height,
+                               g.pockets.data(), g.pockets.size(), pp.pocketMargin};
+        IntegrateKernel fixedKernel = profile.kernels->matching(isa);
+        IndexedIntegrateKernel fixedIndexed = profile.kernels->indexed;
+
+        BallStore a, b;
+        double fixedAll = timeIntegrate(start, substeps, a, [&](BallStore& s) { fixedKernel(s, params); });
+        double genericAll = timeIntegrate(start, substeps, b, [&](BallStore& s) { isa(s, params); });
+        bool sameAll = sameBalls(a, b);
+        double fixedSparse = timeIntegrate(start, substeps, a, [&](BallStore& s) {
+            fixedIndexed(s, sparse.data(), sparse.size(), params);
+        });
+        double genericSparse = timeIntegrate(start, substeps, b, [&](BallStore& s) {
+            generic.indexed(s, sparse.data(), sparse.size(), params);
+        });
+        bool sameSparse = sameBalls(a, b);
+        mismatches += !sameAll + !sameSparse;
+        std::printf("%-10s %-8s %14.0f %16.0f %7.2fx %6s\n", profile.name, "all", fixedAll, genericAll,
+                    genericAll / fixedAll, sameAll ? "yes" : "NO");
+        std::printf("%-10s %-8s %14.0f %16.0f %7.2fx %6s\n", profile.name, "indexed", fixedSparse, genericSparse,
+                    genericSparse / fixedSparse, sameSparse ? "yes" : "NO");
+    }
+    return mismatches;
+}
+
+int main() {
+    int mismatches = 0;
+    std::printf("%-10s %-10s %14s %16s %8s %6s\n", "profile", "scene", "fixed ns/step", "generic ns/step",
+                "speedup", "same");
+    for (const PhysicsProfileInfo& profile : physicsProfiles()) {
+        for (Scene& scene : makeScenes()) {
+            Simulation fixed = scene.sim;
+            fixed.setProfile(profile.name);
+            Simulation generic = scene.sim;
+            generic.setParams(profile.params);
+
+            std::uint64_t hashFixed = 0, hashGeneric = 0;
+            double nsFixed = timeSteps(fixed, scene.steps, hashFixed);
+            double nsGeneric = timeSteps(generic, scene.steps, hashGeneric);
+            bool same = hashFixed == hashGeneric;
+            mismatches += !same;
+            std::printf("%-10s %-10s %14.0f %16.0f %7.2fx %6s\n", profile.name, scene.name, nsFixed, nsGeneric,
+                        nsGeneric / nsFixed, same ? "yes" : "NO");
+        }
+    }
+    mismatches += kernelTable();
+    return mismatches ? 1 : 0;
+}
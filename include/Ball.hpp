@@ -1,29 +1,24 @@
 #pragma once
 #include <SFML/Graphics.hpp>
-#include "Pocket.hpp"
 
+// Внешний вид шара. Позиция и скорость живут в BallStore у физики,
+// рендер только читает их и сюда не пишет. В кадре шары идут из BallAtlas,
+// а draw нужен, чтобы один раз запечь атлас.
 class Ball {
 public:
-    Ball(float x, float y, float radius, sf::Color color,
-         int number = 0, sf::Font* font = nullptr);
+    static constexpr float kOutline = 2.f;
 
-    void setVelocity(sf::Vector2f v);
-    void move(sf::Vector2f delta);
-    void update(float dt);
-    void reflectIfNeeded(const sf::FloatRect& bounds, const std::vector<Pocket>& pockets);
-    bool isNearPocket(const std::vector<Pocket>& pockets) const;
+    Ball(float radius, sf::Color color, int number = 0, sf::Font* font = nullptr);
 
-    sf::Vector2f getPosition() const;
-    sf::Vector2f getVelocity() const;
     float getRadius() const;
     int getNumber() const;
     sf::Color getColor() const;
 
-    void draw(sf::RenderTarget& target) const;
+    // scale увеличивает шар вместе с обводкой и номером; номер растеризуется
+    // сразу в этом размере, а не растягивается потом
+    void draw(sf::RenderTarget& target, sf::Vector2f pos, float scale = 1.f) const;
 
 private:
-    sf::CircleShape circle_;
-    sf::Vector2f velocity_;
     float radius_;
     int number_;
     sf::Font* font_;
@@ -0,0 +1,28 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include "Ball.hpp"
+
+// Атлас лиц шаров: каждый шар (цвет, обводка, номер) рисуется в текстуру один
+// раз при старте. В кадре шар — это текстурированный квадрат, без sf::Text,
+// и кэш глифов шрифта не растёт от анимации падения.
+class BallAtlas {
+public:
+    static constexpr float kOversample = 2.f;   // запас под сглаживание и мипмапы
+
+    // looks индексируются номером шара
+    explicit BallAtlas(const std::vector<Ball>& looks);
+
+    const sf::Texture& texture() const { return texture_; }
+    std::size_t size() const           { return radius_.size(); }
+    // Клетка шара в пикселях атласа
+    sf::FloatRect face(int number) const;
+    // Половина стороны квадрата для шара радиуса radius (с учётом обводки)
+    float halfExtent(int number, float radius) const;
+
+private:
+    sf::Texture texture_;
+    std::vector<float> radius_;     // радиус, с которым запечён шар
+    unsigned cell_ = 0;
+    unsigned columns_ = 1;
+};
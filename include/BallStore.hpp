@@ -0,0 +1,159 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Состояние шара без SFML — годится для headless-прогонов
+struct BallState {
+    float x, y;
+    float vx, vy;
+    float radius;
+    int number;
+};
+
+enum BallFlag : std::uint8_t {
+    kBallCue = 1 << 0,
+    kBallAwake = 1 << 1,    // шар двигается или его только что трогали; спящие физика пропускает
+    kBallTouched = 1 << 2,  // был в контакте на этом шаге — не усыплять до следующего
+};
+
+// Structure-of-arrays: горячие циклы физики трогают только нужные массивы,
+// а копия всего стола — это несколько memcpy.
+// Заодно slot map: у шара есть постоянный id, а индекс в массивах может
+// меняться — удаление переносит последний шар на место удалённого за O(1).
+struct BallStore {
+    std::vector<float> x, y;
+    std::vector<float> vx, vy;
+    std::vector<float> radius;
+    std::vector<std::uint8_t> flags;
+    std::vector<int> number;
+    std::vector<std::uint32_t> id;
+
+    static constexpr std::int32_t kNoSlot = -1;
+
+    std::size_t size() const { return x.size(); }
+    bool empty() const       { return x.empty(); }
+    // Сколько шаров не спит — O(1), счётчик ведут push/erase/wake/sleep
+    std::size_t awakeCount() const { return awake_; }
+    bool isAwake(std::size_t i) const { return flags[i] & kBallAwake; }
+
+    void clear() {
+        x.clear(); y.clear(); vx.clear(); vy.clear();
+        radius.clear(); flags.clear(); number.clear(); id.clear();
+        slots_.clear();
+        awake_ = 0;
+    }
+
+    void reserve(std::size_t n) {
+        x.reserve(n); y.reserve(n); vx.reserve(n); vy.reserve(n);
+        radius.reserve(n); flags.reserve(n); number.reserve(n); id.reserve(n);
+        slots_.reserve(n);
+    }
+
+    // Возвращает id; id не переиспользуются до clear(), так что старый id
+    // никогда не укажет на чужой шар. Новый шар не спит: на первом шаге
+    // физика проверит его перекрытия с соседями
+    std::uint32_t push(const BallState& b) {
+        std::uint32_t newId = static_cast<std::uint32_t>(slots_.size());
+        slots_.push_back(static_cast<std::int32_t>(size()));
+        x.push_back(b.x);
+        y.push_back(b.y);
+        vx.push_back(b.vx);
+        vy.push_back(b.vy);
+        radius.push_back(b.radius);
+        flags.push_back((b.number == 0 ? kBallCue : 0) | kBallAwake);
+        number.push_back(b.number);
+        id.push_back(newId);
+        ++awake_;
+        return newId;
+    }
+
+    // Любая запись скорости или положения снаружи физики должна будить шар,
+    // иначе спящий шар так и останется на месте
+    void wake(std::size_t i) {
+        if (!(flags[i] & kBallAwake)) {
+            flags[i] |= kBallAwake;
+            ++awake_;
+        }
+    }
+
+    void setVelocity(std::size_t i, float newVx, float newVy) {
+        vx[i] = newVx;
+        vy[i] = newVy;
+        wake(i);
+    }
+
+    void setPosition(std::size_t i, float newX, float newY) {
+        x[i] = newX;
+        y[i] = newY;
+        wake(i);
+    }
+
+    // Остановить и усыпить; скорость обнуляется точно (и -0 становится 0)
+    void sleep(std::size_t i) {
+        vx[i] = 0.f;
+        vy[i] = 0.f;
+        if (flags[i] & kBallAwake) {
+            flags[i] &= static_cast<std::uint8_t>(~kBallAwake);
+            --awake_;
+        }
+    }
+
+    BallState get(std::size_t i) const {
+        return {x[i], y[i], vx[i], vy[i], radius[i], number[i]};
+    }
+
+    // Swap-remove: на место i встаёт последний шар, его id остаётся прежним
+    void erase(std::size_t i) {
+        std::size_t last = size() - 1;
+        slots_[id[i]] = kNoSlot;
+        if (flags[i] & kBallAwake)
+            --awake_;
+        if (i != last) {
+            x[i] = x[last];
+            y[i] = y[last];
+            vx[i] = vx[last];
+            vy[i] = vy[last];
+            radius[i] = radius[last];
+            flags[i] = flags[last];
+            number[i] = number[last];
+            id[i] = id[last];
+            slots_[id[i]] = static_cast<std::int32_t>(i);
+        }
+        x.pop_back(); y.pop_back(); vx.pop_back(); vy.pop_back();
+        radius.pop_back(); flags.pop_back(); number.pop_back(); id.pop_back();
+    }
+
+    // Текущий индекс шара или -1, если он убран со стола
+    int indexOf(std::uint32_t ballId) const {
+        return ballId < slots_.size() ? slots_[ballId] : kNoSlot;
+    }
+
+    int find(int ballNumber) const {
+        for (std::size_t i = 0; i < number.size(); ++i)
+            if (number[i] == ballNumber)
+                return static_cast<int>(i);
+        return -1;
+    }
+
+    // Пересобрать таблицу id -> индекс и счётчик бодрствующих
+    // после записи массивов напрямую (снимки)
+    void reindex() {
+        std::uint32_t top = 0;
+        for (std::uint32_t i : id)
+            top = i + 1 > top ? i + 1 : top;
+        if (slots_.size() < top)
+            slots_.resize(top);
+        std::fill(slots_.begin(), slots_.end(), kNoSlot);
+        awake_ = 0;
+        for (std::size_t i = 0; i < id.size(); ++i) {
+            slots_[id[i]] = static_cast<std::int32_t>(i);
+            awake_ += (flags[i] & kBallAwake) ? 1 : 0;
+        }
+    }
+
+private:
+    std::vector<std::int32_t> slots_;   // id -> индекс в массивах
+    std::size_t awake_ = 0;
+};
@@ -0,0 +1,31 @@
+#pragma once
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "BallStore.hpp"
+
+// Равномерная сетка с ячейкой в диаметр самого крупного шара:
+// кандидаты на столкновение ищутся только в соседних ячейках.
+class UniformGrid {
+public:
+    using Pair = std::pair<std::uint32_t, std::uint32_t>;
+
+    // Перестроить сетку и собрать пары (i < j), чьи круги почти касаются.
+    // Пары ищутся только в группах соседей, где есть бодрствующий шар
+    void build(const BallStore& balls, float left, float top, float width, float height);
+
+    const std::vector<Pair>& pairs() const { return pairs_; }
+
+private:
+    int cellOf(float v, float origin, int count) const;
+
+    float cellSize_ = 1.f;
+    int cols_ = 0, rows_ = 0;
+    std::vector<std::uint32_t> cellStart_;  // CSR: начало списка шаров ячейки
+    std::vector<std::uint32_t> cellBalls_;
+    std::vector<std::uint32_t> cellFill_;
+    std::vector<std::uint32_t> ballCell_;
+    std::vector<std::uint8_t> reached_;
+    std::vector<std::uint32_t> queue_;
+    std::vector<Pair> pairs_;
+};
@@ -0,0 +1,32 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "WorkStealingPool.hpp"
+
+// Процедурное сукно: градиент от середины к краям стола в RGBA-буфер.
+// Без SFML — буфер уходит в sf::Texture::update одним вызовом.
+struct ClothParams {
+    unsigned width = 924, height = 500;
+    std::array<std::uint8_t, 4> from{5, 95, 45, 255};
+    std::array<std::uint8_t, 4> to{25, 65, 30, 255};
+    float centerWeight = 0.25f;     // вклад расстояния до середины по x
+    float edgeWeight = 0.6f;        // вклад расстояния до ближайшего края
+
+    // Ключ кэша: меняется при любом изменении параметров или формулы
+    std::uint64_t key() const;
+};
+
+// Строки считаются пачками параллельно в пуле (если он есть), внутри строки —
+// по 4 пикселя на SSE2. Результат побайтно совпадает со старым циклом из main.cpp
+std::vector<std::uint8_t> generateCloth(const ClothParams& params, WorkStealingPool* pool = nullptr);
+
+// Кэш на диске: файл cloth_<key>.rgba в cacheDir. load возвращает false,
+// если файла нет или он от других параметров
+bool loadClothCache(const std::string& cacheDir, const ClothParams& params, std::vector<std::uint8_t>& rgba);
+bool saveClothCache(const std::string& cacheDir, const ClothParams& params, const std::vector<std::uint8_t>& rgba);
+
+// Взять из кэша, а если там нет — сгенерировать и сохранить
+std::vector<std::uint8_t> loadOrGenerateCloth(const std::string& cacheDir, const ClothParams& params,
+                                              WorkStealingPool* pool = nullptr);
@@ -0,0 +1,81 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "BallStore.hpp"
+#include "BroadPhase.hpp"
+
+class WorkStealingPool;
+
+// Счётчики решателя: последний вызов и всего с начала
+struct ContactStats {
+    std::size_t contacts = 0;
+    std::size_t islands = 0;
+    int iterations = 0;                 // больше всего итераций скоростей среди островов
+    std::uint64_t solves = 0;           // вызовов, в которых были контакты
+    std::uint64_t totalIterations = 0;  // сумма iterations по ним
+};
+
+// Контакты шар-шар за подшаг целиком, а не по парам.
+// Из пар-кандидатов broad phase собирается граф касаний и делится на острова
+// (связные кучки шаров). В острове — последовательные импульсы по нормали:
+// накопленный импульс контакта не меньше нуля, упругость только для
+// сближения быстрее kBounceSpeed, иначе шары просто перестают сходиться.
+// Импульс начинается с прошлого подшага (warm start), поэтому постоянные
+// контакты сходятся за пару проходов. Перекрытие убирается отдельно, сдвигом
+// позиций без изменения скоростей.
+// Порядок обхода — по номерам шаров, а не по индексам в BallStore и не по
+// порядку пар, так что результат от них не зависит. Острова независимы:
+// с пулом крупные сцены решаются параллельно, результат побитово тот же.
+class ContactSolver {
+public:
+    static constexpr int kVelocityIterations = 16;
+    static constexpr int kPositionIterations = 8;
+    static constexpr float kTolerance = 1e-3f;      // px/s: импульсы почти не меняются — хватит
+    static constexpr float kBounceSpeed = 2.f;      // px/s
+    static constexpr float kSlop = 0.01f;           // такое перекрытие (px) не разводим
+    static constexpr float kPositionFactor = 0.8f;  // доля перекрытия за один проход
+    static constexpr float kWarmNormal = 0.9f;      // нормаль повернулась сильнее — импульс не берём
+    static constexpr std::size_t kParallelContacts = 256;
+
+    // Пул для крупных сцен; nullptr — всё в вызывающем потоке.
+    // Не задавать, если сама симуляция крутится в задаче этого пула
+    void setPool(WorkStealingPool* pool) { pool_ = pool; }
+    // Забыть импульсы прошлого подшага — стол заменён целиком
+    void reset() { cache_.clear(); }
+
+    // candidates — пары индексов (i < j) в любом порядке; касание — перекрытие кругов.
+    // Тронутые шары получают kBallTouched
+    void solve(BallStore& balls, const std::vector<UniformGrid::Pair>& candidates, float restitution);
+
+    const ContactStats& stats() const { return stats_; }
+
+private:
+    struct Contact {
+        std::uint32_t a, b;         // a — шар с меньшим номером
+        std::uint64_t order;        // номера шаров: канонический порядок
+        std::uint64_t key;          // id шаров: ключ для warm start
+        std::uint32_t island;
+        float nx, ny;               // от a к b
+        float target;               // нужная скорость расхождения
+        float impulse;              // накопленный
+    };
+
+    struct Cached {
+        std::uint64_t key;
+        float impulse;
+        float nx, ny;
+    };
+
+    std::uint32_t find(std::uint32_t i);
+    // Контакты [begin, end) одного острова; возвращает число итераций скоростей
+    int solveIsland(BallStore& balls, std::size_t begin, std::size_t end, float restitution);
+
+    std::vector<Contact> contacts_;
+    std::vector<std::uint32_t> parent_;
+    std::vector<std::size_t> islandStart_;
+    std::vector<int> islandIterations_;
+    std::vector<Cached> cache_, next_;      // по key, импульсы прошлого подшага
+    WorkStealingPool* pool_ = nullptr;
+    ContactStats stats_;
+};
@@ -1,17 +1,24 @@
 #pragma once
 #include <SFML/Graphics.hpp>
+#include <array>
 
+// Кий: тень, древко с градиентом по вершинам и наконечник — 18 вершин,
+// которые пересчитываются на месте. Один draw-вызов, без текстур.
 class Cue {
 public:
+    static constexpr float kWidth = 6.f;
+    static constexpr float kTipLength = 11.f;
+
     Cue();
 
-    void update(sf::Vector2f start, sf::Vector2f end, float power, bool visible);
-    void draw(sf::RenderWindow& window) const;
+    // Древко длины length от start в сторону end, наконечник упирается в end
+    void update(sf::Vector2f start, sf::Vector2f end, float length, bool visible);
+    void draw(sf::RenderTarget& target) const;
 
 private:
-    sf::RectangleShape shape_;
-    float length_;
-    float power_;
-    bool visible_;
+    void setQuad(std::size_t first, sf::Vector2f from, sf::Vector2f to, sf::Color cFrom, sf::Color cTo);
+
+    std::array<sf::Vertex, 18> vertices_;
     sf::Vector2f direction_;
+    bool visible_;
 };
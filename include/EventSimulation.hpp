@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+#include <queue>
+#include <vector>
+#include "Simulation.hpp"
+
+// Событийный движок: при постоянном замедлении трением движение шара
+// задаётся в замкнутой форме, поэтому моменты ударов о шары и борта,
+// падения в лузу и остановки решаются точно, без шагов по времени.
+// Физика та же, что у Simulation, но без туннелирования и поправок на перекрытие.
+class EventSimulation {
+public:
+    // Параметры физики — те же, что у sim
+    explicit EventSimulation(const Simulation& sim);
+    EventSimulation(const TableGeometry& table, const BallStore& balls,
+                    const PhysicsParams& params = PyramidProfile::kParams);
+
+    // Обработать все события до момента t (сек) и выставить шары на это время
+    void advanceTo(double t);
+    // Прогнать до полной остановки; забитые шары складываются в pocketed.
+    // Возвращает число обработанных событий.
+    int simulateUntilRest(std::vector<int>* pocketed = nullptr, int maxEvents = 200000);
+
+    double time() const { return now_; }
+    // Номера забитых шаров в порядке падения
+    const std::vector<int>& pocketed() const { return pocketed_; }
+    // Состояние шаров на момент time(); забитые шары из него убраны
+    BallStore balls() const;
+
+private:
+    // Скорости ниже этой считаются нулём: иначе почти стоящие шары в плотной
+    // кучке порождают бесконечную цепочку ударов в один и тот же момент
+    static constexpr double kMinSpeed = 1e-3;
+
+    enum class EventType { Stop, Cushion, PocketZoneExit, Pocket, Ball };
+
+    struct Motion {
+        double x, y;    // позиция в момент t0
+        double vx, vy;
+        double t0;
+        std::uint32_t version = 0;
+        bool active = true;
+    };
+
+    struct Event {
+        double t;
+        EventType type;
+        std::uint32_t i, j;
+        std::uint32_t vi, vj;
+        int side;       // борт (0..3) или номер лузы
+        bool operator>(const Event& o) const { return t > o.t; }
+    };
+
+    void init();
+    Motion stateAt(std::size_t i, double t) const;
+    void sync(std::size_t i, double t);
+    void settle(Motion& m) const;
+    void predict(std::size_t i);
+    void predictPair(std::size_t i, std::size_t j);
+    void process(const Event& e);
+    bool isNearPocket(double x, double y) const;
+    void push(double t, EventType type, std::size_t i, std::size_t j, int side);
+
+    TableGeometry table_;
+    BallStore balls_;
+    PhysicsParams params_;
+    std::vector<Motion> motion_;
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> queue_;
+    double decel_;
+    std::vector<int> pocketed_;
+    double now_ = 0.0;
+};
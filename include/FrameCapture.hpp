@@ -0,0 +1,81 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Запись кадров на диск в фоне. Поток рендера копирует пиксели в свободный
+// буфер из пула и ставит его в очередь; кодируют и пишут рабочие потоки.
+// Буферов ограниченное число — это и есть длина очереди: рендер ждёт, только
+// если все они ещё в работе, а файлы никогда не трогает.
+// Форматы: PNG-последовательность (frame_000000.png...) или несжатое видео
+// YUV4MPEG2 4:2:0 — у него кадры одного размера, поэтому потоки пишут каждый
+// свой кадр сразу на его место в файле, без упорядочивания.
+class FrameCapture {
+public:
+    enum class Format { Png, Y4m };
+
+    struct Options {
+        Format format = Format::Png;
+        std::string path;               // каталог для PNG, файл для y4m
+        unsigned width = 0, height = 0; // для y4m — чётные
+        unsigned fps = 60;
+        unsigned workers = 0;           // 0 — по числу ядер, минус поток рендера
+        std::size_t queueFrames = 0;    // 0 — по два кадра на рабочий поток
+    };
+
+    explicit FrameCapture(const Options& options);
+    // Дописывает всё, что в очереди
+    ~FrameCapture();
+
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+
+    // false — не удалось создать каталог или файл, см. error()
+    bool ok() const;
+    std::string error() const;
+
+    // Поток рендера: кадр RGBA width*height*4, строки сверху вниз
+    void push(const std::uint8_t* rgba);
+    // Дождаться записи всех кадров и остановить потоки; false — была ошибка
+    bool finish();
+
+    std::uint64_t frames() const    { return next_; }
+    unsigned workers() const        { return workers_; }
+    // Сколько поток рендера простоял в push(), ожидая свободный буфер
+    double stallSeconds() const     { return stallSeconds_; }
+
+private:
+    struct Job {
+        std::uint64_t index;
+        std::size_t buffer;
+    };
+
+    void work();
+    // file — свой у каждого потока, открывается при первом кадре
+    bool writeY4m(const Job& job, std::vector<std::uint8_t>& yuv, std::FILE*& file) const;
+    bool writePng(const Job& job) const;
+
+    Options options_;
+    std::size_t frameBytes_ = 0;
+    std::uint64_t y4mHeader_ = 0;   // длина заголовка файла
+    unsigned workers_ = 0;
+
+    std::vector<std::vector<std::uint8_t>> buffers_;
+    std::vector<std::size_t> free_;
+    std::deque<Job> jobs_;
+    bool stop_ = false;
+    std::string error_;
+    mutable std::mutex m_;
+    std::condition_variable work_, done_;
+    std::vector<std::thread> threads_;
+
+    // Поток рендера
+    std::uint64_t next_ = 0;
+    double stallSeconds_ = 0.0;
+};
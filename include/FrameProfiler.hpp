@@ -0,0 +1,83 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Фазы кадра игрового цикла; Frame — весь кадр целиком
+enum class FramePhase : std::uint8_t {
+    Picking,    // поиск шара под линией прицела
+    Input,      // события окна, удары, подсказка
+    Physics,    // physics->update
+    Pockets,    // разбор событий луз и запись в лог
+    Animation,  // падающие шары, анимация кия, остановка стола
+    Draw,       // стол, шары, кий
+    Hud,        // текст счёта и оверлей профайлера
+    Present,    // window.display, включая ожидание vsync/лимита кадров
+    Frame,
+    Count
+};
+
+struct PhaseStats {
+    double p50 = 0, p99 = 0, max = 0, mean = 0;     // микросекунды
+    std::uint64_t count = 0;
+};
+
+// Таймеры фаз кадра. Игровой цикл идёт фазами подряд, поэтому таймер — "круг":
+// lap(фаза) относит к фазе время с предыдущей отметки. Выключенный профайлер
+// стоит одну проверку флага на фазу, его можно оставлять в релизной сборке.
+// Последние kWindow кадров хранятся в кольце — по ним оверлей считает p50/p99/max.
+// За всю сессию копится логарифмическая гистограмма — её пишет дамп при выходе.
+class FrameProfiler {
+public:
+    using Clock = std::chrono::steady_clock;
+    static constexpr std::size_t kWindow = 240;
+    static constexpr std::size_t kPhases = static_cast<std::size_t>(FramePhase::Count);
+
+    void setEnabled(bool on) { enabled_ = on; }
+    bool enabled() const     { return enabled_; }
+
+    void beginFrame();
+    // Закрыть фазу, закончившуюся сейчас
+    void lap(FramePhase phase) {
+        if (inFrame_)
+            lapSlow(phase);
+    }
+    void endFrame();
+
+    // По кольцу последних кадров
+    PhaseStats recent(FramePhase phase) const;
+    // По всей сессии, с точностью до корзины гистограммы (~9%)
+    PhaseStats session(FramePhase phase) const;
+    std::uint64_t frames() const { return frames_; }
+    // Время от запуска до первого показанного кадра — в оверлей и в JSON
+    void setFirstFrame(double ms) { firstFrameMs_ = ms; }
+    double firstFrame() const     { return firstFrameMs_; }
+
+    // Таблица "фаза p50 p99 max" для оверлея
+    std::string overlayText() const;
+    // CSV: последние кадры по строке, фазы по столбцам (мкс). JSON: сводка за сессию
+    bool writeCsv(const std::string& path) const;
+    bool writeJson(const std::string& path) const;
+
+private:
+    // Корзины по 1/8 октавы от 1/8 мкс: 8 * 24 корзин хватает до ~2 с
+    static constexpr int kBucketsPerOctave = 8;
+    static constexpr int kBuckets = kBucketsPerOctave * 24;
+    static int bucketOf(double us);
+    static double bucketValue(int bucket);
+    void lapSlow(FramePhase phase);
+
+    bool enabled_ = false;
+    bool inFrame_ = false;
+    Clock::time_point frameStart_, mark_;
+    std::array<float, kPhases> current_{};              // фазы текущего кадра, мкс
+    std::vector<std::array<float, kPhases>> ring_;      // последние кадры
+    std::size_t ringNext_ = 0;
+    std::uint64_t frames_ = 0;
+    std::array<std::array<std::uint32_t, kBuckets>, kPhases> histogram_{};
+    std::array<double, kPhases> sum_{};
+    std::array<double, kPhases> max_{};
+    double firstFrameMs_ = 0.0;
+};
@@ -0,0 +1,56 @@
+#pragma once
+#include "TableState.hpp"
+
+// Правила русской пирамиды в этой игре: бить можно любой шар, каждый забитый
+// прицельный шар — очко тому, кто бил. Промах или биток в лузе — ход переходит;
+// упавший биток после остановки стола возвращается на своё место.
+struct GameRules {
+    int ballsToWin = 8;
+};
+
+// Итог удара, когда стол остановился
+struct ShotResult {
+    int scored = 0;             // прицельные шары, забитые этим ударом
+    bool scratch = false;       // биток в лузе
+    bool turnPassed = false;
+    bool respotCue = false;     // вернуть биток на cueStart, если его нет на столе
+};
+
+// Счёт и очередь хода одной партии. Физики не знает: игра сообщает ей
+// о начале удара, о шарах в лузах и об остановке стола.
+class GameState {
+public:
+    explicit GameState(const GameRules& rules = {}) : rules_(rules) {}
+
+    // Новая партия; биток стоит на (cueX, cueY)
+    void reset(float cueX, float cueY);
+
+    void beginShot();
+    void onPocket(int ballNumber);
+    ShotResult endShot();
+
+    // Счёт, ход и место битка хранятся в снимке стола вместе с шарами
+    void save(TableState& state) const;
+    // Удар, оборванный откатом, забывается
+    void load(const TableState& state);
+
+    const GameRules& rules() const { return rules_; }
+    int score(int player) const    { return score_[player - 1]; }
+    int player() const             { return player_; }
+    // 0 — партия идёт
+    int winner() const;
+    bool over() const              { return winner() != 0; }
+    bool shotInProgress() const    { return inShot_; }
+    float cueStartX() const        { return cueX_; }
+    float cueStartY() const        { return cueY_; }
+
+private:
+    GameRules rules_;
+    int score_[2] = {0, 0};
+    int player_ = 1;
+    float cueX_ = 0.f, cueY_ = 0.f;
+
+    bool inShot_ = false;
+    int scored_ = 0;
+    bool cuePocketed_ = false;
+};
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "BallStore.hpp"
+
+struct PocketState;
+
+// Параметры одного шага интегрирования: трение, борта и зоны луз
+struct IntegrateParams {
+    float dt;
+    float decel;        // mu * g * dt
+    float cushion;
+    float left, top, right, bottom;
+    const PocketState* pockets;
+    std::size_t pocketCount;
+    float pocketMargin;
+};
+
+// Сдвиг, трение и отражение от бортов для всех шаров.
+// Все реализации дают побитово одинаковый результат: ветвления заменены масками,
+// а скалярный вариант считает теми же операциями в том же порядке.
+using IntegrateKernel = void (*)(BallStore& balls, const IntegrateParams& params);
+
+void integrateScalar(BallStore& balls, const IntegrateParams& params);
+// Только перечисленные шары — когда бодрствует малая часть стола.
+// Спящий шар (скорость ровно 0) — неподвижная точка любого ядра, так что
+// пропуск остальных не меняет результат
+void integrateIndexed(BallStore& balls, const std::uint32_t* indices, std::size_t count,
+                      const IntegrateParams& params);
+#if defined(__x86_64__) || defined(__i386__)
+void integrateSse(BallStore& balls, const IntegrateParams& params);
+void integrateAvx2(BallStore& balls, const IntegrateParams& params);
+#endif
+
+using IndexedIntegrateKernel = void (*)(BallStore& balls, const std::uint32_t* indices, std::size_t count,
+                                        const IntegrateParams& params);
+
+// Ядра одной физики под все наборы инструкций. Общий набор (функции выше) читает
+// трение, борт и зону лузы из IntegrateParams; набор профиля собран с его
+// константами и берёт из params только dt и геометрию стола
+struct IntegrateKernelSet {
+    IntegrateKernel scalar;
+    IntegrateKernel sse;            // nullptr вне x86
+    IntegrateKernel avx2;
+    IndexedIntegrateKernel indexed;
+
+    // Ядро набора с теми же инструкциями, что у kernel из общего набора;
+    // любое другое ядро возвращается как есть
+    IntegrateKernel matching(IntegrateKernel kernel) const;
+};
+
+const IntegrateKernelSet& genericIntegrateKernels();
+// Есть для профилей из PhysicsProfile.hpp
+template <class Profile>
+const IntegrateKernelSet& integrateKernelsFor();
+
+// Лучшее ядро для текущего процессора (выбирается один раз при первом вызове)
+IntegrateKernel selectIntegrateKernel();
+const char* integrateKernelName(IntegrateKernel kernel);
@@ -1,20 +1,59 @@
 #pragma once
+#include <memory>
+#include <string>
 #include <vector>
-#include "Ball.hpp"
+#include <SFML/Graphics.hpp>
 #include "Table.hpp"
 #include "Pocket.hpp"
+#include "SimulationThread.hpp"
 
+// SFML-обёртка над физикой в отдельном потоке (SimulationThread).
+// Игра видит стол только для чтения: balls() — последний снимок с позициями,
+// интерполированными между двумя последними шагами. Изменения уходят командами.
 class PhysicsEngine {
 public:
-    PhysicsEngine(std::vector<Ball>& balls, const Table& table, const std::vector<Pocket>& pockets);
+    // Партии пишутся в logDir (пустой — не пишутся); profile — из physicsProfiles();
+    // spectatorPort — трансляция для зрителей на 127.0.0.1 (0 — выключена)
+    PhysicsEngine(const Table& table, const std::vector<Pocket>& pockets, std::string logDir = {},
+                  const std::string& profile = PyramidProfile::kName, std::uint16_t spectatorPort = 0);
 
-    void update(float dt);
+    // Раз в кадр: забрать свежий снимок и события луз, пересчитать интерполяцию
+    void update();
+
+    const BallStore& balls() const { return view_; }
+    // Последнее состояние физики без интерполяции — для снимков отмены и подсказки
+    const TableState& state() const { return state_; }
+    // Копия стола для перебора ударов (ShotSolver), с тем же профилем
+    Simulation simulation() const;
+    const std::string& profile() const { return profile_; }
+
+    // Шары, упавшие в лузы с прошлого clearPocketEvents(); события стола,
+    // который уже заменили через restore(), отброшены
+    const std::vector<PocketEvent>& pocketEvents() const { return pocketEvents_; }
+    void clearPocketEvents()                             { pocketEvents_.clear(); }
+    // Движется ли что-то — с учётом команд, которые физика ещё не применила
+    bool isMoving() const;
+    // Тики и подшаги физики, число зрителей — для оверлея профайлера
+    const SimStats& stats() const { return thread_->snapshot().stats; }
+
+    void shoot(std::size_t i, sf::Vector2f dir, float power);
+    // Вернуть шар на стол, если его там нет
+    void respot(int number, sf::Vector2f pos, float radius);
+    // Заменить весь стол; запись партии закрывается и начинается новая
+    void restore(const TableState& state);
+
+    sf::Vector2f getPosition(std::size_t i) const;
 
 private:
-    void resolveCollisions();
-    void resolveBallBall(Ball& a, Ball& b);
+    void adopt(const TableState& state);
 
-    std::vector<Ball>& balls_;
-    const Table& table_;
-    const std::vector<Pocket>& pockets_;
+    TableGeometry geometry_;
+    std::string profile_;
+    std::unique_ptr<SimulationThread> thread_;
+    TableState state_;
+    BallStore view_;
+    std::vector<PocketEvent> pocketEvents_;
+    std::uint64_t sentSeq_ = 0;     // последняя отправленная команда
+    std::uint64_t syncSeq_ = 0;     // последняя команда, уже отражённая в view_ локально
+    std::uint64_t restoreSeq_ = 0;  // события луз до неё — от старого стола
 };
@@ -0,0 +1,49 @@
+#pragma once
+#include <string>
+#include <vector>
+
+class Simulation;
+struct IntegrateKernelSet;
+
+// Параметры сукна, шаров и луз: всё, что отличает один стол от другого в физике
+struct PhysicsParams {
+    float mu;               // трение качения
+    float gravity;
+    float restitution;      // удар шар-шар
+    float cushion;          // борт
+    float pocketMargin;     // вблизи лузы борт не отражает
+    float captureDepth;     // шар падает, когда центр глубже r*captureDepth внутри лузы
+};
+
+// Профили стола. Константы известны при компиляции: Simulation собирает шаг
+// и ядра интегрирования под каждый профиль отдельно, и они сворачиваются
+// прямо в код
+struct PyramidProfile {
+    static constexpr const char* kName = "pyramid";
+    static constexpr PhysicsParams kParams{1.3f, 9.81f, 0.95f, 0.85f, 1.15f, 0.2f};
+};
+
+// Пул: сукно быстрее, борта мягче, лузы шире
+struct PoolProfile {
+    static constexpr const char* kName = "pool";
+    static constexpr PhysicsParams kParams{1.0f, 9.81f, 0.93f, 0.8f, 1.2f, 0.2f};
+};
+
+// Снукер: самое быстрое сукно и тесные лузы
+struct SnookerProfile {
+    static constexpr const char* kName = "snooker";
+    static constexpr PhysicsParams kParams{0.8f, 9.81f, 0.94f, 0.75f, 1.05f, 0.3f};
+};
+
+// Запись реестра: имя, параметры, шаг Simulation и ядра интегрирования,
+// специализированные под них
+struct PhysicsProfileInfo {
+    const char* name;
+    PhysicsParams params;
+    void (*step)(Simulation& sim);
+    const IntegrateKernelSet* kernels;
+};
+
+// Все профили; первый — по умолчанию
+const std::vector<PhysicsProfileInfo>& physicsProfiles();
+const PhysicsProfileInfo* findPhysicsProfile(const std::string& name);
@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "Simulation.hpp"
+
+// Запись партии: стартовый стол и всё, что игра меняет в физике между шагами
+// (удары и переставленные шары), с номером тика. Лузы — часть шага физики,
+// их записывать не нужно. Раз в
+// kChecksumInterval тиков пишется хэш состояния. Воспроизведение гоняет
+// Simulation без окна и сверяет хэши — так проверяются изменения физики
+// на сохранённых партиях.
+enum class LogEvent : std::uint8_t {
+    Shot = 1,       // ball — индекс шара, x/y — направление, power — сила
+    Place = 3,      // ball — номер шара, x/y/vx/vy/radius; шара нет на столе — он ставится
+    Checksum = 4,   // checksum — Simulation::stateHash()
+};
+
+struct LogRecord {
+    LogEvent type;
+    std::uint64_t tick;     // от начала записи
+    std::int32_t ball = 0;
+    float x = 0.f, y = 0.f;
+    float vx = 0.f, vy = 0.f;
+    float radius = 0.f;
+    float power = 0.f;
+    std::uint64_t checksum = 0;
+};
+
+struct ReplayResult {
+    bool ok = true;
+    std::uint64_t ticks = 0;
+    std::size_t checksums = 0;      // сколько хэшей сверено
+    std::uint64_t failedTick = 0;   // первый тик, где состояние разошлось
+};
+
+class ShotLog {
+public:
+    // 3: профиль физики, записи версии 2 — pyramid; 4: режим ударов, 2 и 3 — Grid
+    static constexpr std::uint32_t kVersion = 4;
+    static constexpr std::uint64_t kChecksumInterval = 240;    // раз в секунду игры
+
+    // Начать новую запись с текущего состояния sim
+    void begin(const Simulation& sim);
+
+    void shot(const Simulation& sim, int ball, float dirX, float dirY, float power);
+    // Вызывать после того, как шар переставлен: состояние берётся из sim
+    void place(const Simulation& sim, int number);
+    // Раз в кадр: пишет хэш, если с прошлого прошло kChecksumInterval тиков
+    void frame(const Simulation& sim);
+    // Хэш на текущем тике — перед сохранением, чтобы конец партии тоже сверялся
+    void finish(const Simulation& sim);
+
+    std::size_t shots() const;
+    const TableGeometry& table() const               { return table_; }
+    const std::string& profile() const               { return profile_; }
+    CollisionMode collisionMode() const              { return collisionMode_; }
+    const std::vector<BallState>& initial() const    { return initial_; }
+    const std::vector<LogRecord>& records() const    { return records_; }
+
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+
+    // Прогнать запись с нуля без окна и сверить все хэши.
+    // onTick — стол в начале и после каждого шага (например, для рендера роликов)
+    ReplayResult replay(const std::function<void(const Simulation&)>& onTick = {}) const;
+
+private:
+    std::uint64_t ticks(const Simulation& sim) const { return sim.tick() - startTick_; }
+    void checksum(const Simulation& sim);
+
+    TableGeometry table_{};
+    std::string profile_ = PyramidProfile::kName;
+    CollisionMode collisionMode_ = CollisionMode::Contacts;
+    std::vector<BallState> initial_;
+    std::vector<LogRecord> records_;
+    std::uint64_t startTick_ = 0;
+    std::uint64_t nextChecksum_ = 0;
+};
@@ -0,0 +1,48 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <vector>
+#include "Simulation.hpp"
+#include "WorkStealingPool.hpp"
+
+// Удар: какой шар бьём, направление (рад) и сила (px/s) — как в main.cpp
+struct Shot {
+    int ball;
+    float angle;
+    float power;
+};
+
+struct ShotOutcome {
+    Shot shot;
+    int pocketed;   // забитые прицельные шары (номер > 0)
+    bool scratch;   // биток в лузе — ход переходит
+    float score;
+};
+
+struct ShotSearchParams {
+    int angleSteps = 72;
+    std::vector<float> powers = {300.f, 700.f, 1100.f, 1600.f};
+    std::vector<int> balls;                     // пусто — перебирать все шары
+    std::chrono::microseconds budget{0};        // 0 — без ограничения по времени
+    bool exact = true;                          // EventSimulation вместо шагов Simulation
+    std::size_t maxResults = 8;
+};
+
+// Перебор сетки (шар, угол, сила) с прогоном каждого удара до остановки на копии стола.
+// Кандидаты раздаются по ядрам через WorkStealingPool; при заданном бюджете
+// сначала идёт грубая сетка углов, потом она уплотняется.
+class ShotSolver {
+public:
+    explicit ShotSolver(WorkStealingPool& pool);
+
+    std::vector<ShotOutcome> search(const Simulation& table, const ShotSearchParams& params);
+    // Сколько кандидатов успел посчитать последний search()
+    std::size_t lastEvaluated() const { return lastEvaluated_; }
+
+    static ShotOutcome evaluate(Simulation& scratch, const Shot& shot, bool exact);
+
+private:
+    WorkStealingPool& pool_;
+    std::vector<Simulation> scratch_;   // по копии стола на поток
+    std::size_t lastEvaluated_ = 0;
+};
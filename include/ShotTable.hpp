@@ -0,0 +1,76 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "MappedFile.hpp"
+#include "Simulation.hpp"
+#include "TableLayout.hpp"
+#include "WorkStealingPool.hpp"
+
+// Удар битком в прицельный шар на лузу, сведённый к нескольким числам.
+// Углы знаковые, в системе лузы: ось направлена из лузы в стол
+// (для угловой — по биссектрисе), отражённые лузы приводятся к верхней левой
+// и верхней средней
+struct ShotQuery {
+    bool sidePocket = false;
+    float cueDistance = 0.f;     // биток → точка удара («призрачный шар»), px
+    float cut = 0.f;             // срез: от линии шар → луза к направлению удара, рад
+    float pocketDistance = 0.f;  // прицельный шар → центр лузы, px
+    float approach = 0.f;        // от оси лузы к направлению луза → шар, рад
+    float power = 0.f;           // px/s
+};
+
+// Заранее посчитанная вероятность забить срез: генератор прогоняет
+// EventSimulation по сетке параметров с разбросом прицела, игра отображает
+// файл в память и читает ответ за 32 обращения с интерполяцией по сетке.
+// В заголовке записаны константы физики и размеры стола — таблица, посчитанная
+// с другими, не открывается.
+class ShotTable {
+public:
+    static constexpr std::uint32_t kVersion = 2;    // 2: удар шаров — импульс по нормали (ContactSolver)
+
+    struct Axis {
+        float min, max;
+        std::uint32_t count;
+    };
+
+    struct Grid {
+        Axis cueDistance{0.f, 560.f, 8};
+        Axis cut{-1.3f, 1.3f, 21};          // ±75°
+        Axis pocketDistance{40.f, 740.f, 8};
+        Axis approach{-1.05f, 1.05f, 9};    // ±60°
+        Axis power{300.f, 1600.f, 6};
+        std::uint32_t trials = 6;           // ударов на ячейку
+        float aimJitter = 0.015f;           // разброс прицела, ±рад
+    };
+
+    // Посчитать таблицу для стола layout с физикой params и записать в path
+    static bool build(const TableLayout& layout, const Grid& grid, WorkStealingPool& pool, const std::string& path,
+                      const PhysicsParams& params = PyramidProfile::kParams);
+
+    // Отобразить файл; false — нет файла, чужой формат или другая физика (см. error())
+    bool open(const std::string& path, const TableLayout& layout,
+              const PhysicsParams& params = PyramidProfile::kParams);
+    void close();
+    bool loaded() const                { return cells_ != nullptr; }
+    const std::string& error() const   { return error_; }
+
+    // 0..1; положения вне сетки прижимаются к краю, недостижимые ячейки не учитываются
+    float probability(const ShotQuery& q) const;
+    // Удар битком cue в шар object на лузу pocket (индексы в balls и table.pockets)
+    static ShotQuery describe(const TableGeometry& table, const BallStore& balls,
+                              int cue, int object, int pocket, float power);
+    float probability(const TableGeometry& table, const BallStore& balls,
+                      int cue, int object, int pocket, float power) const;
+
+private:
+    static constexpr std::uint8_t kUnreachable = 255;
+    static constexpr int kAxes = 5;
+
+    MappedFile file_;
+    Axis axes_[kAxes]{};
+    const std::uint8_t* cells_ = nullptr;
+    std::size_t stride_[kAxes]{};
+    std::size_t kindStride_ = 0;
+    std::string error_;
+};
@@ -0,0 +1,135 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "BallStore.hpp"
+#include "BroadPhase.hpp"
+#include "ContactSolver.hpp"
+#include "IntegrateKernel.hpp"
+#include "PhysicsProfile.hpp"
+
+struct PocketState {
+    float x, y;
+    float radius;
+};
+
+struct TableGeometry {
+    float left, top, width, height;
+    std::vector<PocketState> pockets;
+};
+
+// Шар упал в лузу на шаге tick; x/y — где он был, для анимации падения
+struct PocketEvent {
+    std::uint64_t tick;
+    std::uint32_t id;
+    int number;
+    int pocket;
+    float x, y;
+};
+
+enum class CollisionMode {
+    Pairwise,   // эталонный O(n²) перебор всех пар
+    Grid,       // равномерная сетка (UniformGrid)
+    Contacts,   // сетка + ContactSolver: все касания подшага вместе, от порядка пар не зависит
+};
+
+class Simulation {
+public:
+    static constexpr float kFixedDt = 1.f / 240.f;
+    static constexpr float kMaxFrameDt = 0.25f;  // защита от "спирали смерти" после зависаний
+    static constexpr std::size_t kSparseIntegrate = 4;  // бодрствует меньше 1/4 стола — интегрируем поштучно
+    // Шаг дробится на подшаги, чтобы самый быстрый шар проходил за подшаг не больше
+    // kMaxTravel самого малого радиуса — иначе он проскакивает шары и лузы насквозь
+    static constexpr float kMaxTravel = 0.5f;
+    static constexpr int kMaxSubsteps = 16;
+
+    // Параметры стола по умолчанию (PyramidProfile); у экземпляра — params()
+    static constexpr float kMu = PyramidProfile::kParams.mu;
+    static constexpr float kGravity = PyramidProfile::kParams.gravity;
+    static constexpr float kRestitution = PyramidProfile::kParams.restitution;
+    static constexpr float kCushion = PyramidProfile::kParams.cushion;
+    static constexpr float kPocketMargin = PyramidProfile::kParams.pocketMargin;
+    static constexpr float kCaptureDepth = PyramidProfile::kParams.captureDepth;
+
+    explicit Simulation(const TableGeometry& table, const std::vector<BallState>& balls = {});
+
+    // Один детерминированный шаг фиксированной длины: движение, удары, лузы.
+    // Работает только с бодрствующими шарами; если спят все — просто тикает.
+    // Быстрые шары — несколько подшагов (kMaxTravel); при обычных скоростях подшаг один
+    void step() { step_(*this); }
+    // Накопить реальное время кадра и сделать нужное число фиксированных шагов
+    int advance(float dt);
+    // Крутить шаги, пока всё не остановится; забитые шары складываются в pocketed.
+    // События луз при этом вычитываются
+    int simulateUntilRest(std::vector<int>* pocketed = nullptr, int maxSteps = 240 * 600);
+
+    // Шары, упавшие в лузы с прошлого clearPocketEvents(), в порядке падения.
+    // Со стола они уже убраны
+    const std::vector<PocketEvent>& pocketEvents() const { return pocketEvents_; }
+    void clearPocketEvents()                             { pocketEvents_.clear(); }
+    // O(1): спят ли все шары. Внешняя запись скоростей будит шар (BallStore::setVelocity)
+    bool isAtRest() const { return balls_.awakeCount() == 0; }
+    // Хэш положений, скоростей и номеров шаров — для сверки при воспроизведении
+    std::uint64_t stateHash() const;
+
+    // Профиль из physicsProfiles(): шаг — специализация под его константы.
+    // false — профиля с таким именем нет, остаётся прежний
+    bool setProfile(const std::string& name);
+    // Произвольные параметры: общий шаг, который читает их из памяти
+    void setParams(const PhysicsParams& params);
+    const PhysicsParams& params() const { return params_; }
+    // Пусто после setParams
+    const std::string& profile() const  { return profile_; }
+
+    // Pairwise и Grid — прежний удар по парам (сдвиг + обмен скоростями);
+    // на них записаны старые партии
+    void setCollisionMode(CollisionMode mode) { collisionMode_ = mode; }
+    CollisionMode collisionMode() const       { return collisionMode_; }
+    // Пул для решателя контактов в крупных сценах (ContactSolver::setPool)
+    void setContactPool(WorkStealingPool* pool) { contacts_.setPool(pool); }
+    // Стол заменён целиком: импульсы прошлого шага больше ни к чему не относятся
+    void resetContacts()                        { contacts_.reset(); }
+    const ContactStats& contactStats() const    { return contacts_.stats(); }
+    // По умолчанию — лучшее SIMD-ядро для процессора (selectIntegrateKernel).
+    // Ядро из общего набора; у профиля шаг берёт его версию с теми же инструкциями
+    void setIntegrateKernel(IntegrateKernel kernel) { kernel_ = kernel; }
+    IntegrateKernel integrateKernel() const         { return kernel_; }
+
+    BallStore& balls()                  { return balls_; }
+    const BallStore& balls() const      { return balls_; }
+    const TableGeometry& table() const  { return table_; }
+    std::uint64_t tick() const          { return tick_; }
+    // Подшагов в последнем шаге и всего с начала — для профайлера
+    int lastSubsteps() const            { return lastSubsteps_; }
+    std::uint64_t substeps() const      { return substeps_; }
+
+private:
+    friend const std::vector<PhysicsProfileInfo>& physicsProfiles();
+
+    // P — константы профиля или параметры в памяти (см. Simulation.cpp)
+    template <class P> static void stepWith(Simulation& sim);
+    template <class P> void run(const P& p);
+    template <class P> void integrate(const P& p, float dt);
+    template <class P> void resolveCollisions(const P& p);
+    template <class P> void resolveBallBall(const P& p, std::size_t a, std::size_t b);
+    template <class P> void capturePockets(const P& p);
+    int substepsNeeded();
+    void settle();
+
+    TableGeometry table_;
+    PhysicsParams params_ = PyramidProfile::kParams;
+    std::string profile_ = PyramidProfile::kName;
+    void (*step_)(Simulation&);
+    BallStore balls_;
+    CollisionMode collisionMode_ = CollisionMode::Contacts;
+    UniformGrid grid_;
+    ContactSolver contacts_;
+    std::vector<PocketEvent> pocketEvents_;
+    std::vector<std::uint32_t> awake_;   // индексы бодрствующих на начало шага
+    IntegrateKernel kernel_ = selectIntegrateKernel();
+    const IntegrateKernelSet* kernels_ = &integrateKernelsFor<PyramidProfile>();
+    float accumulator_ = 0.f;
+    std::uint64_t tick_ = 0;
+    int lastSubsteps_ = 0;
+    std::uint64_t substeps_ = 0;
+};
@@ -0,0 +1,123 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ShotLog.hpp"
+#include "Simulation.hpp"
+#include "SpectatorServer.hpp"
+#include "SpscQueue.hpp"
+#include "TableState.hpp"
+#include "TripleBuffer.hpp"
+
+// Изменение стола от игры; поток физики применяет его между шагами
+struct SimCommand {
+    enum Type : std::uint8_t {
+        Shot,       // ball — id шара, x/y — направление, power — сила
+        Respot,     // number/radius на место x/y, если такого шара нет на столе
+        Restore,    // весь стол из state; запись партии закрывается и начинается новая
+    };
+    Type type = Shot;
+    std::uint64_t seq = 0;      // назначает SimulationThread::send
+    std::uint32_t ball = 0;
+    int number = 0;
+    float x = 0.f, y = 0.f;
+    float power = 0.f;
+    float radius = 0.f;
+    TableState state;
+};
+
+// Счётчики физики с запуска потока: сколько тиков что-то двигалось
+// и сколько подшагов на них ушло (Simulation::kMaxTravel); зрители трансляции
+struct SimStats {
+    std::uint64_t ticks = 0;
+    std::uint64_t movingTicks = 0;
+    std::uint64_t substeps = 0;
+    int lastSubsteps = 0;
+    std::uint32_t viewers = 0;
+};
+
+// Состояние стола после тика; prevX/prevY — те же шары тиком раньше,
+// чтобы рендер мог интерполировать между двумя последними шагами
+struct SimSnapshot {
+    std::uint64_t tick = 0;
+    std::int64_t tickTimeNs = 0;    // steady_clock: когда этот тик был положен по расписанию
+    std::uint64_t appliedSeq = 0;   // последняя применённая команда
+    bool moving = false;
+    SimStats stats;
+    TableState state;
+    float prevX[TableState::kMaxBalls];
+    float prevY[TableState::kMaxBalls];
+};
+
+// Шар в лузе вместе с номером последней применённой команды — по нему
+// игра отбрасывает события стола, который уже откатили
+struct SimPocketEvent {
+    PocketEvent event;
+    std::uint64_t appliedSeq;
+};
+
+// Физика в своём потоке с фиксированным шагом Simulation::kFixedDt, независимо
+// от частоты кадров. Команды приходят через SPSC-очередь, состояние уходит
+// через тройной буфер, забитые шары — отдельной очередью (их терять нельзя).
+// Запись партии (ShotLog) ведётся здесь же: только этот поток знает, на каком
+// тике применён удар. Отсюда же после каждого шага кодируются кадры для
+// зрителей (SpectatorServer), если трансляция включена.
+class SimulationThread {
+public:
+    using Clock = std::chrono::steady_clock;
+    static constexpr std::size_t kCommandQueue = 64;
+    static constexpr std::size_t kPocketQueue = 64;
+
+    // logDir пустой — партии не сохраняются; profile — из physicsProfiles();
+    // spectatorPort 0 — без трансляции
+    SimulationThread(const TableGeometry& table, std::string logDir,
+                     const std::string& profile = PyramidProfile::kName, std::uint16_t spectatorPort = 0);
+    // Останавливает поток и сохраняет текущую запись
+    ~SimulationThread();
+
+    SimulationThread(const SimulationThread&) = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+
+    // Дальше — только из потока игры.
+    // Возвращает номер команды; если очередь полна, ждёт
+    std::uint64_t send(SimCommand command);
+    // true, если пришло новое состояние
+    bool poll()                         { return snapshots_.update(); }
+    const SimSnapshot& snapshot() const { return snapshots_.front(); }
+    bool popPocket(SimPocketEvent& out) { return pockets_.pop(out); }
+    // nullptr — трансляция выключена
+    const SpectatorServer* spectator() const { return spectator_.get(); }
+
+private:
+    void run();
+    void apply(const SimCommand& command);
+    void step();
+    void publish();
+    void saveLog();
+
+    Simulation sim_;
+    ShotLog log_;
+    std::string logDir_;
+    std::unique_ptr<SpectatorServer> spectator_;
+
+    SpscQueue<SimCommand, kCommandQueue> commands_;
+    SpscQueue<SimPocketEvent, kPocketQueue> pockets_;
+    TripleBuffer<SimSnapshot> snapshots_;
+    std::uint64_t nextSeq_ = 1;             // поток игры
+
+    // Поток физики
+    std::uint64_t appliedSeq_ = 0;
+    std::int64_t tickTimeNs_ = 0;
+    SimStats stats_;
+    std::vector<SimPocketEvent> pendingPockets_;    // не влезли в очередь
+    std::vector<float> prevById_;                   // x, y по id шара до шага
+    float prevX_[TableState::kMaxBalls];
+    float prevY_[TableState::kMaxBalls];
+
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+};
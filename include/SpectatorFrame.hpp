@@ -0,0 +1,99 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Simulation.hpp"
+
+// Поток кадров для зрителей. Кадр — [u32 длина][тип][тик][контрольная сумма][тело]:
+//   ключевой — размеры стола, лузы и все шары;
+//   дельта   — сколько тиков до кадра, от которого она считается, забитые шары
+//              (id и луза), новые шары и только сдвинувшиеся — разностью квантов.
+// Координаты — целые в 1/kScale px от левого верхнего угла стола, целые — varint.
+// Контрольная сумма — по всем шарам после кадра, от порядка не зависит:
+// клиент сверяет с ней восстановленный стол.
+enum class SpectatorFrame : std::uint8_t {
+    Keyframe = 1,
+    Delta = 2,
+};
+
+using SpectatorBuffer = std::vector<std::uint8_t>;
+
+// Поток физики: кадр на тик. Ключевой — раз в kKeyframeInterval тиков и после
+// reset(); между ними дельты, а если ни один шар не сдвинулся на квант — ничего.
+// Кадр кодируется один раз и дальше только читается: все зрители шлют один буфер
+class SpectatorEncoder {
+public:
+    static constexpr std::uint64_t kKeyframeInterval = 240;
+    static constexpr float kScale = 8.f;
+    static constexpr std::size_t kLengthSize = 4;       // префикс длины кадра
+    static constexpr std::uint8_t kNoPocket = 255;      // шар пропал не в лузу
+
+    // Тип кадра по буферу с префиксом длины
+    static SpectatorFrame type(const SpectatorBuffer& frame) {
+        return static_cast<SpectatorFrame>(frame[kLengthSize]);
+    }
+
+    // nullptr — зрителю нечего показать
+    std::shared_ptr<const SpectatorBuffer> encode(const Simulation& sim);
+    // Стол заменён целиком — следующий кадр ключевой
+    void reset() { needKey_ = true; }
+
+private:
+    struct Ball {
+        std::int32_t x, y;
+        int number;
+        bool present;
+    };
+
+    std::vector<Ball> last_;            // по id шара: что видит зритель
+    std::vector<std::uint32_t> ids_;    // шары последнего кадра
+    std::vector<std::uint32_t> removed_, added_, moved_;
+    std::uint64_t lastKey_ = 0;
+    std::uint64_t lastTick_ = 0;
+    bool needKey_ = true;
+};
+
+// Шар стола, восстановленного по кадрам
+struct SpectatorBall {
+    std::uint32_t id;
+    int number;
+    float x, y, radius;
+};
+
+// Клиент: собирает кадры из потока байт и восстанавливает стол.
+// До первого ключевого кадра дельты пропускаются
+class SpectatorDecoder {
+public:
+    // Байты из сокета в любой нарезке; false — поток испорчен
+    bool feed(const std::uint8_t* data, std::size_t size);
+
+    bool synced() const                  { return synced_; }
+    std::uint64_t tick() const           { return tick_; }
+    const TableGeometry& table() const   { return table_; }
+    std::vector<SpectatorBall> balls() const;
+    // Контрольная сумма восстановленного стола — та же функция, что у кодировщика
+    std::uint32_t checksum() const;
+
+    std::uint64_t frames() const         { return frames_; }
+    std::uint64_t keyframes() const      { return keyframes_; }
+    std::uint64_t skipped() const        { return skipped_; }
+    std::uint64_t mismatches() const     { return mismatches_; }
+    std::uint64_t pocketed() const       { return pocketed_; }
+
+private:
+    struct Ball {
+        std::int32_t x, y, radius;
+        int number;
+        bool present;
+    };
+
+    bool decode(const std::uint8_t* data, std::size_t size);
+
+    std::vector<std::uint8_t> pending_;
+    std::vector<Ball> balls_;           // по id
+    TableGeometry table_{};
+    std::uint64_t tick_ = 0;
+    bool synced_ = false;
+    std::uint64_t frames_ = 0, keyframes_ = 0, skipped_ = 0, mismatches_ = 0, pocketed_ = 0;
+};
@@ -0,0 +1,76 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "SpectatorFrame.hpp"
+#include "SpscQueue.hpp"
+#include "TcpSocket.hpp"
+
+// Трансляция стола зрителям на 127.0.0.1. Поток физики только кодирует кадр
+// и кладёт указатель в SPSC-очередь; сеть — в своём потоке. Один буфер кадра
+// уходит всем зрителям прямо из памяти, без копий. Сокеты неблокирующие:
+// зритель, у которого скопилось больше kMaxBacklog байт (несколько секунд
+// движения), теряет очередь и ждёт ключевого кадра — физика его никогда не ждёт.
+// Буфер ядра урезан до kSocketBuffer, чтобы отставание копилось здесь, а не там.
+class SpectatorServer {
+public:
+    static constexpr std::size_t kFrameQueue = 1024;
+    static constexpr std::size_t kMaxBacklog = 64 * 1024;
+    static constexpr std::size_t kSocketBuffer = 32 * 1024;
+    static constexpr int kPollMs = 2;
+
+    // port 0 — любой свободный; listening() false — порт занят
+    explicit SpectatorServer(std::uint16_t port);
+    ~SpectatorServer();
+
+    SpectatorServer(const SpectatorServer&) = delete;
+    SpectatorServer& operator=(const SpectatorServer&) = delete;
+
+    bool listening() const      { return port_ != 0; }
+    std::uint16_t port() const  { return port_; }
+
+    // Поток физики: после каждого шага, пока события луз ещё не сброшены.
+    // Без зрителей ничего не кодирует
+    void publish(const Simulation& sim);
+    // Поток физики: стол заменён целиком
+    void reset()                { encoder_.reset(); }
+
+    // Счётчики для оверлея и проверки; читать можно из любого потока
+    std::size_t viewers() const             { return viewerCount_.load(std::memory_order_relaxed); }
+    std::uint64_t framesSent() const        { return framesSent_.load(std::memory_order_relaxed); }
+    std::uint64_t bytesSent() const         { return bytesSent_.load(std::memory_order_relaxed); }
+    std::uint64_t framesDropped() const     { return framesDropped_.load(std::memory_order_relaxed); }
+
+private:
+    using Frame = std::shared_ptr<const SpectatorBuffer>;
+
+    struct Viewer {
+        TcpSocket socket;
+        std::deque<Frame> queue;
+        std::size_t offset = 0;         // отправлено байт из queue.front()
+        std::size_t backlog = 0;        // байт в очереди, не считая отправленных
+        bool waitKey = true;
+    };
+
+    void run();
+    void enqueue(const Frame& frame);
+    // false — зритель отключился
+    bool flush(Viewer& viewer);
+
+    SpectatorEncoder encoder_;          // поток физики
+    SpscQueue<Frame, kFrameQueue> frames_;
+
+    // Сетевой поток
+    TcpSocket listener_;
+    std::vector<Viewer> viewers_;
+
+    std::uint16_t port_ = 0;
+    std::atomic<std::size_t> viewerCount_{0};
+    std::atomic<std::uint64_t> framesSent_{0}, bytesSent_{0}, framesDropped_{0};
+    std::atomic<bool> wantKey_{false};     // новый или отставший зритель ждёт ключевой кадр
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+};
@@ -0,0 +1,43 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Очередь без блокировок на одного писателя и одного читателя.
+// Capacity — степень двойки; индексы растут монотонно, переполнение
+// отличается от пустоты разностью head - tail.
+template <typename T, std::size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    // Только поток-писатель; false, если очередь полна
+    bool push(const T& value) {
+        std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == Capacity)
+            return false;
+        items_[head & (Capacity - 1)] = value;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Только поток-читатель; false, если очередь пуста
+    bool pop(T& out) {
+        std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire))
+            return false;
+        out = items_[tail & (Capacity - 1)];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return tail_.load(std::memory_order_acquire) == head_.load(std::memory_order_acquire);
+    }
+
+private:
+    // Счётчики на разных кэш-линиях, чтобы писатель и читатель не толкались
+    alignas(64) std::atomic<std::size_t> head_{0};
+    alignas(64) std::atomic<std::size_t> tail_{0};
+    alignas(64) std::array<T, Capacity> items_{};
+};
@@ -0,0 +1,17 @@
+#pragma once
+#include "BallStore.hpp"
+#include "Simulation.hpp"
+
+// Размеры стола и стартовая расстановка — общие для игры, бенчмарков и утилит
+struct TableLayout {
+    float x = 50.f, y = 50.f;
+    float width = 924.f, height = 500.f;
+    float ballRadius = 15.f;
+    float pocketRadius = 17.f;
+    int ballsCount = 15;
+
+    // Поле и шесть луз: четыре угловые и две средние
+    TableGeometry geometry() const;
+    // Биток на четверти стола и пирамида из ballsCount шаров
+    void rack(BallStore& balls) const;
+};
@@ -0,0 +1,43 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include "BallAtlas.hpp"
+#include "TableLayout.hpp"
+#include "TrajectoryPreview.hpp"
+
+// Пакетный рендер стола: борта и лузы собираются в вершинный массив один раз,
+// тени и подсветка каждый кадр дописываются в общий массив треугольников,
+// а шары — квадратами из BallAtlas. На кадр три draw-вызова вместо десятков.
+class TableRenderer {
+public:
+    static constexpr std::size_t kCircleSegments = 30;   // как у sf::CircleShape по умолчанию
+
+    // atlas должен жить дольше рендера
+    TableRenderer(const TableLayout& layout, const BallAtlas& atlas, float borderThickness, float borderShadow);
+
+    // Начать новый кадр: массив шаров очищается, память остаётся
+    void beginFrame();
+    void addCircle(sf::Vector2f center, float radius, sf::Color color);
+    // Тень со смещением "от лампы"
+    void addShadow(sf::Vector2f center, float radius);
+    // Лицо шара из атласа; alpha — для анимации падения в лузу
+    void addBall(sf::Vector2f center, float radius, int number, sf::Uint8 alpha = 255);
+    // Ломаная из отрезков-полосок шириной width, под шарами
+    void addPath(const std::vector<PathPoint>& points, float width, sf::Color color);
+
+    void drawStatic(sf::RenderTarget& target) const;
+    void drawDynamic(sf::RenderTarget& target) const;
+
+    std::size_t dynamicVertexCount() const { return dynamic_.getVertexCount() + faces_.getVertexCount(); }
+
+private:
+    static void appendCircle(sf::VertexArray& va, const std::vector<sf::Vector2f>& unit,
+                             sf::Vector2f center, float radius, sf::Color color);
+    static void appendRect(sf::VertexArray& va, sf::FloatRect rect, sf::Color color);
+
+    std::vector<sf::Vector2f> unit_;    // точки единичной окружности
+    sf::VertexArray static_;
+    sf::VertexArray dynamic_;
+    sf::VertexArray faces_;
+    const BallAtlas* atlas_;
+};
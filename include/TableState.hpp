@@ -0,0 +1,87 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include "BallStore.hpp"
+
+// Плоский снимок партии: шары, счёт, чей ход, место битка. Один блок без
+// указателей — копируется memcpy, снимок и откат стоят доли микросекунды.
+// Годится и для отмены ходов, и как быстрый клон стола для перебора ударов.
+struct TableState {
+    static constexpr std::size_t kMaxBalls = 32;
+
+    std::uint32_t ballCount = 0;
+    std::uint32_t onTable = 0;      // бит на номер шара: 1 — на столе, 0 — забит
+    float x[kMaxBalls], y[kMaxBalls];
+    float vx[kMaxBalls], vy[kMaxBalls];
+    float radius[kMaxBalls];
+    std::int32_t number[kMaxBalls];
+    std::uint8_t flags[kMaxBalls];
+    std::uint32_t id[kMaxBalls];
+
+    // Поля игры; физика их не трогает
+    std::int32_t score[2] = {0, 0};
+    std::int32_t player = 1;
+    float cueStartX = 0.f, cueStartY = 0.f;
+
+    static bool fits(const BallStore& balls) { return balls.size() <= kMaxBalls; }
+    // Шары берутся из balls; поля игры остаются как были.
+    // false — шаров больше kMaxBalls (см. fits), снимок не тронут
+    bool capture(const BallStore& balls);
+    // Вектора BallStore меняют размер, но при достаточной ёмкости не перевыделяются;
+    // id шаров возвращаются те же, что были при снимке
+    void restore(BallStore& balls) const;
+    bool pocketed(int ballNumber) const { return !((onTable >> ballNumber) & 1u); }
+};
+
+static_assert(std::is_trivially_copyable<TableState>::value, "TableState must stay memcpy-able");
+
+// Снимки из заранее выделенных страниц: взять и вернуть блок — без обращения к куче
+class TableStateArena {
+public:
+    explicit TableStateArena(std::size_t blocksPerPage = 64);
+
+    TableStateArena(const TableStateArena&) = delete;
+    TableStateArena& operator=(const TableStateArena&) = delete;
+
+    TableState* acquire();
+    void release(TableState* state);
+    std::size_t live() const { return live_; }
+
+private:
+    std::vector<std::unique_ptr<TableState[]>> pages_;
+    std::vector<TableState*> free_;
+    std::size_t blocksPerPage_;
+    std::size_t live_ = 0;
+};
+
+// Многоуровневая отмена: стек снимков ограниченной глубины, самый старый
+// вытесняется, когда стек полон. Стек — кольцо из depth указателей,
+// выделенное в конструкторе: push и pop к куче не обращаются
+class UndoHistory {
+public:
+    explicit UndoHistory(TableStateArena& arena, std::size_t depth = 64);
+    ~UndoHistory();
+
+    UndoHistory(const UndoHistory&) = delete;
+    UndoHistory& operator=(const UndoHistory&) = delete;
+
+    // Новый снимок на вершине стека; заполняет вызывающий
+    TableState& push();
+    // Снять верхний снимок в out; false, если отменять нечего
+    bool pop(TableState& out);
+    void clear();
+
+    std::size_t size() const { return size_; }
+    bool empty() const       { return size_ == 0; }
+
+private:
+    TableState*& at(std::size_t k) { return ring_[(bottom_ + k) % ring_.size()]; }
+
+    TableStateArena& arena_;
+    std::vector<TableState*> ring_;
+    std::size_t bottom_ = 0;    // самый старый снимок
+    std::size_t size_ = 0;
+};
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Неблокирующий TCP-сокет на 127.0.0.1: BSD-сокеты или Winsock (-lws2_32).
+// Только то, что нужно трансляции для зрителей, — наружу не слушает
+class TcpSocket {
+public:
+    TcpSocket() = default;
+    ~TcpSocket() { close(); }
+
+    TcpSocket(TcpSocket&& other) noexcept : handle_(other.handle_) { other.handle_ = kInvalid; }
+    TcpSocket& operator=(TcpSocket&& other) noexcept;
+    TcpSocket(const TcpSocket&) = delete;
+    TcpSocket& operator=(const TcpSocket&) = delete;
+
+    // port 0 — любой свободный, см. localPort()
+    static TcpSocket listen(std::uint16_t port);
+    // Соединение ждётся блокирующе, дальше сокет неблокирующий
+    static TcpSocket connect(std::uint16_t port);
+    // Невалидный, если никто не ждёт
+    TcpSocket accept() const;
+
+    bool valid() const { return handle_ != kInvalid; }
+    std::uint16_t localPort() const;
+    // Размеры буферов ядра, 0 — оставить как есть
+    void setBuffers(std::size_t send, std::size_t receive);
+    void close();
+
+    // Сколько байт ушло/пришло; 0 — сейчас нельзя, -1 — ошибка или соединение закрыто
+    long send(const void* data, std::size_t size);
+    long recv(void* data, std::size_t size);
+
+    std::intptr_t handle() const { return handle_; }
+
+private:
+    static constexpr std::intptr_t kInvalid = -1;
+    explicit TcpSocket(std::intptr_t handle) : handle_(handle) {}
+
+    std::intptr_t handle_ = kInvalid;
+};
+
+// Ожидание готовности нескольких сокетов (poll/WSAPoll)
+struct SocketWait {
+    const TcpSocket* socket = nullptr;
+    bool read = false, write = false;       // чего ждать
+    bool readable = false, writable = false, failed = false;
+};
+
+// Число готовых сокетов; timeoutMs < 0 — ждать без ограничения
+int waitSockets(std::vector<SocketWait>& sockets, int timeoutMs);
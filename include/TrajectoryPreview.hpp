@@ -0,0 +1,67 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Simulation.hpp"
+#include "TableState.hpp"
+
+struct PathPoint {
+    float x, y;
+};
+
+// Путь одного шара: точки в местах смены направления (борт, удар), последняя —
+// где шар сейчас в расчёте, остановился или упал в лузу
+struct PredictedPath {
+    std::uint32_t id = 0;
+    int number = 0;
+    bool pocketed = false;
+    std::vector<PathPoint> points;
+};
+
+// Предсказание удара при прицеливании: тот же Simulation, что и у игры,
+// поэтому для стоящего стола путь совпадает с настоящим до бита.
+// Расчёт идёт кусками в пределах бюджета на кадр и продолжается в следующих
+// кадрах; прицел, сдвинувшийся меньше допуска, расчёт не сбрасывает.
+// Ведутся пути битого шара и шаров, которых он коснётся первыми.
+class TrajectoryPreview {
+public:
+    static constexpr float kAngleTolerance = 0.002f;    // рад
+    static constexpr float kPowerTolerance = 0.01f;     // доля силы
+    static constexpr int kMaxSteps = 240 * 10;
+    static constexpr float kContactSlack = 0.5f;        // зазор, при котором шары считаются коснувшимися
+    static constexpr float kTurnCos = 0.9998f;          // поворот больше ~1° — новая точка пути
+
+    explicit TrajectoryPreview(const TableGeometry& table, const std::string& profile = PyramidProfile::kName);
+
+    // Прицел по состоянию table; ball — индекс шара в нём.
+    // Другой стол или заметно другой прицел — расчёт начинается заново
+    void aim(const TableState& table, std::size_t ball, float dirX, float dirY, float power);
+    // Посчитать ещё шагов в пределах budget; true, когда всё остановилось
+    bool advance(std::chrono::microseconds budget);
+    void clear();
+
+    bool active() const                             { return active_; }
+    bool complete() const                           { return complete_; }
+    int steps() const                               { return steps_; }
+    const std::vector<PredictedPath>& paths() const { return paths_; }
+
+private:
+    void restart();
+    void step();
+    void track(PredictedPath& path, std::size_t slot);
+    static bool sameTable(const TableState& a, const TableState& b);
+
+    Simulation sim_;
+    TableState base_;
+    std::size_t ball_ = 0;
+    float dirX_ = 0.f, dirY_ = 0.f, power_ = 0.f;
+    float angle_ = 0.f;
+
+    bool active_ = false;
+    bool complete_ = false;
+    bool contact_ = false;          // первое касание битого шара уже было
+    int steps_ = 0;
+    std::vector<PredictedPath> paths_;
+    std::vector<PathPoint> heading_;    // скорость в последней точке каждого пути
+};
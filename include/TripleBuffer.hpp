@@ -0,0 +1,35 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// Тройной буфер без блокировок: писатель публикует полные состояния,
+// читатель всегда берёт самое свежее. Ни одна сторона не ждёт другую;
+// промежуточные состояния, которые читатель не успел забрать, теряются.
+// Писатель заполняет back() целиком перед каждым publish().
+template <typename T>
+class TripleBuffer {
+public:
+    // Поток-писатель
+    T& back() { return buffers_[back_]; }
+    void publish() {
+        back_ = middle_.exchange(back_ | kFresh, std::memory_order_acq_rel) & kIndex;
+    }
+
+    // Поток-читатель: true, если с прошлого вызова опубликовано новое состояние
+    bool update() {
+        if (!(middle_.load(std::memory_order_relaxed) & kFresh))
+            return false;
+        front_ = middle_.exchange(front_, std::memory_order_acq_rel) & kIndex;
+        return true;
+    }
+    const T& front() const { return buffers_[front_]; }
+
+private:
+    static constexpr std::uint8_t kIndex = 3;
+    static constexpr std::uint8_t kFresh = 4;    // в middle_ лежит неотданное состояние
+
+    T buffers_[3]{};
+    std::uint8_t back_ = 0;     // принадлежит писателю
+    std::uint8_t front_ = 2;    // принадлежит читателю
+    alignas(64) std::atomic<std::uint8_t> middle_{1};
+};
@@ -0,0 +1,49 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Пул потоков для parallelFor: у каждого потока свой диапазон индексов,
+// опустевший поток забирает половину хвоста у соседа.
+// Вызывающий поток работает как worker 0.
+class WorkStealingPool {
+public:
+    using Task = std::function<void(std::size_t index, unsigned worker)>;
+
+    explicit WorkStealingPool(unsigned threads = std::thread::hardware_concurrency());
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(ranges_.size()); }
+
+    // fn(index, worker) для каждого index в [0, count); возвращается, когда всё выполнено
+    void parallelFor(std::size_t count, const Task& fn);
+
+private:
+    struct alignas(64) Range {
+        std::mutex m;
+        std::size_t begin = 0, end = 0;
+    };
+
+    void workerLoop(unsigned id);
+    void drain(unsigned id);
+    bool popOwn(unsigned id, std::size_t& index);
+    bool steal(unsigned id);
+
+    std::vector<std::unique_ptr<Range>> ranges_;
+    std::vector<std::thread> threads_;
+
+    std::mutex m_;
+    std::condition_variable wake_, done_;
+    std::uint64_t generation_ = 0;
+    unsigned busy_ = 0;
+    bool stop_ = false;
+    const Task* task_ = nullptr;
+};
@@ -0,0 +1,38 @@
+#include "BallAtlas.hpp"
+#include <algorithm>
+#include <cmath>
+
+BallAtlas::BallAtlas(const std::vector<Ball>& looks) {
+    float maxRadius = 1.f;
+    for (const auto& look : looks) {
+        radius_.push_back(look.getRadius());
+        maxRadius = std::max(maxRadius, look.getRadius());
+    }
+    // +1 пиксель поля, чтобы при фильтрации не цеплять соседа
+    cell_ = static_cast<unsigned>(std::ceil(2.f * (maxRadius + Ball::kOutline + 1.f) * kOversample));
+    columns_ = std::max(1u, static_cast<unsigned>(std::ceil(std::sqrt(static_cast<float>(looks.size())))));
+    unsigned rows = (static_cast<unsigned>(looks.size()) + columns_ - 1) / columns_;
+
+    sf::RenderTexture canvas;
+    canvas.create(cell_ * columns_, cell_ * std::max(1u, rows));
+    canvas.clear(sf::Color::Transparent);
+    for (std::size_t n = 0; n < looks.size(); ++n) {
+        sf::FloatRect r = face(static_cast<int>(n));
+        looks[n].draw(canvas, {r.left + r.width / 2.f, r.top + r.height / 2.f}, kOversample);
+    }
+    canvas.display();
+
+    texture_ = canvas.getTexture();
+    texture_.setSmooth(true);
+    texture_.generateMipmap();
+}
+
+sf::FloatRect BallAtlas::face(int number) const {
+    unsigned n = static_cast<unsigned>(number);
+    return sf::FloatRect(static_cast<float>((n % columns_) * cell_), static_cast<float>((n / columns_) * cell_),
+                         static_cast<float>(cell_), static_cast<float>(cell_));
+}
+
+float BallAtlas::halfExtent(int number, float radius) const {
+    return radius * cell_ / (2.f * kOversample * radius_[number]);
+}
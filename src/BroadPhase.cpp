@@ -0,0 +1,80 @@
+#include "BroadPhase.hpp"
+#include <algorithm>
+#include <cmath>
+
+int UniformGrid::cellOf(float v, float origin, int count) const {
+    int c = static_cast<int>(std::floor((v - origin) / cellSize_));
+    return std::clamp(c, 0, count - 1);
+}
+
+void UniformGrid::build(const BallStore& balls, float left, float top, float width, float height) {
+    pairs_.clear();
+    const std::size_t n = balls.size();
+    if (n < 2)
+        return;
+
+    float maxRadius = *std::max_element(balls.radius.begin(), balls.radius.end());
+    // Запас: разводка перекрытий внутри шага сдвигает шары, и пара,
+    // не касавшаяся на момент сборки, может сойтись до своей очереди
+    float margin = 0.5f * maxRadius;
+    cellSize_ = std::max(2.f * maxRadius + margin, 1.f);
+    cols_ = std::max(1, static_cast<int>(std::ceil(width / cellSize_)));
+    rows_ = std::max(1, static_cast<int>(std::ceil(height / cellSize_)));
+
+    // Counting sort шаров по ячейкам — без аллокаций после прогрева
+    const std::size_t cells = static_cast<std::size_t>(cols_) * rows_;
+    cellStart_.assign(cells + 1, 0);
+    ballCell_.resize(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        int cx = cellOf(balls.x[i], left, cols_);
+        int cy = cellOf(balls.y[i], top, rows_);
+        ballCell_[i] = static_cast<std::uint32_t>(cy * cols_ + cx);
+        ++cellStart_[ballCell_[i] + 1];
+    }
+    for (std::size_t c = 0; c < cells; ++c)
+        cellStart_[c + 1] += cellStart_[c];
+    cellBalls_.resize(n);
+    cellFill_.assign(cellStart_.begin(), cellStart_.end() - 1);
+    for (std::size_t i = 0; i < n; ++i)
+        cellBalls_[cellFill_[ballCell_[i]]++] = static_cast<std::uint32_t>(i);
+
+    // Обход от бодрствующих шаров по графу "почти касаются": спящая группа,
+    // которой коснулся движущийся шар, разбирается целиком в том же шаге,
+    // как и без сна. Группы, где все спят, не трогаем вовсе
+    reached_.assign(n, 0);
+    queue_.clear();
+    for (std::size_t i = 0; i < n; ++i)
+        if (balls.isAwake(i)) {
+            reached_[i] = 1;
+            queue_.push_back(static_cast<std::uint32_t>(i));
+        }
+    for (std::size_t q = 0; q < queue_.size(); ++q) {
+        std::uint32_t i = queue_[q];
+        int cx = static_cast<int>(ballCell_[i] % cols_);
+        int cy = static_cast<int>(ballCell_[i] / cols_);
+        for (int ny = std::max(cy - 1, 0); ny <= std::min(cy + 1, rows_ - 1); ++ny) {
+            for (int nx = std::max(cx - 1, 0); nx <= std::min(cx + 1, cols_ - 1); ++nx) {
+                std::size_t c = static_cast<std::size_t>(ny) * cols_ + nx;
+                for (std::uint32_t k = cellStart_[c]; k < cellStart_[c + 1]; ++k) {
+                    std::uint32_t j = cellBalls_[k];
+                    if (j == i)
+                        continue;
+                    float dx = balls.x[j] - balls.x[i];
+                    float dy = balls.y[j] - balls.y[i];
+                    float r = balls.radius[i] + balls.radius[j] + margin;
+                    if (!(dx * dx + dy * dy < r * r))
+                        continue;
+                    if (!reached_[j]) {
+                        reached_[j] = 1;
+                        queue_.push_back(j);
+                    }
+                    // Оба конца пары будут обойдены — берём её со стороны меньшего
+                    if (i < j)
+                        pairs_.push_back({i, j});
+                }
+            }
+        }
+    }
+    // Тот же порядок обхода, что и у эталонного двойного цикла
+    std::sort(pairs_.begin(), pairs_.end());
+}
@@ -0,0 +1,190 @@
+#include "ClothTexture.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+// Как и в ядрах интегрирования: без FMA, чтобы SIMD и скалярный хвост
+// давали те же байты
+#if defined(__clang__)
+#pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+namespace {
+
+// Поднять при изменении формулы в generateCloth — старые кэши станут чужими
+constexpr std::uint32_t kClothVersion = 1;
+constexpr char kMagic[4] = {'C', 'L', 'T', 'H'};
+
+struct CacheHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t width, height;
+    std::uint64_t key;
+};
+
+std::string cachePath(const std::string& dir, const ClothParams& params) {
+    char name[40];
+    std::snprintf(name, sizeof(name), "cloth_%016llx.rgba", static_cast<unsigned long long>(params.key()));
+    return (std::filesystem::path(dir) / name).string();
+}
+
+} // namespace
+
+std::uint64_t ClothParams::key() const {
+    // FNV-1a по полям: побайтно, без паддинга структуры
+    std::uint64_t h = 1469598103934665603ull;
+    auto mix = [&h](const void* data, std::size_t size) {
+        const auto* p = static_cast<const std::uint8_t*>(data);
+        for (std::size_t i = 0; i < size; ++i) {
+            h ^= p[i];
+            h *= 1099511628211ull;
+        }
+    };
+    mix(&kClothVersion, sizeof(kClothVersion));
+    mix(&width, sizeof(width));
+    mix(&height, sizeof(height));
+    mix(from.data(), from.size());
+    mix(to.data(), to.size());
+    mix(&centerWeight, sizeof(centerWeight));
+    mix(&edgeWeight, sizeof(edgeWeight));
+    return h;
+}
+
+std::vector<std::uint8_t> generateCloth(const ClothParams& params, WorkStealingPool* pool) {
+    const unsigned w = params.width, h = params.height;
+    std::vector<std::uint8_t> rgba(static_cast<std::size_t>(w) * h * 4);
+    if (w == 0 || h == 0)
+        return rgba;
+
+    // Всё, что зависит только от x, считается один раз на столбец
+    const float fw = static_cast<float>(w), fh = static_cast<float>(h);
+    std::vector<float> center(w), edgeX(w);
+    for (unsigned x = 0; x < w; ++x) {
+        float dist = std::abs(static_cast<int>(w) / 2 - static_cast<int>(x)) / (fw / 2);
+        center[x] = params.centerWeight * dist;
+        edgeX[x] = std::min(x / fw, (fw - 1 - x) / fw);
+    }
+
+    const float r0 = params.from[0], g0 = params.from[1], b0 = params.from[2], a0 = params.from[3];
+    const float dr = static_cast<float>(params.to[0] - params.from[0]);
+    const float dg = static_cast<float>(params.to[1] - params.from[1]);
+    const float db = static_cast<float>(params.to[2] - params.from[2]);
+    const float da = static_cast<float>(params.to[3] - params.from[3]);
+
+    const float edgeWeight = params.edgeWeight;
+    auto row = [&](std::size_t y) {
+        const std::size_t n = w;
+        const float edgeY = std::min(y / fh, (fh - 1 - y) / fh);
+        const float* cx = center.data();
+        const float* ex = edgeX.data();
+        std::uint8_t* out = rgba.data() + y * n * 4;
+        std::size_t x = 0;
+#if defined(__x86_64__) || defined(__i386__)
+        // По 4 пикселя: каналы считаются во float, упаковываются в 32-битные
+        // RGBA-слова (little-endian) и пишутся одним store
+        const __m128 vEdgeY = _mm_set1_ps(edgeY), vWeight = _mm_set1_ps(edgeWeight);
+        const __m128 vr0 = _mm_set1_ps(r0), vg0 = _mm_set1_ps(g0), vb0 = _mm_set1_ps(b0), va0 = _mm_set1_ps(a0);
+        const __m128 vdr = _mm_set1_ps(dr), vdg = _mm_set1_ps(dg), vdb = _mm_set1_ps(db), vda = _mm_set1_ps(da);
+        const __m128i low = _mm_set1_epi32(0xFF);
+        for (; x + 4 <= n; x += 4) {
+            __m128 t = _mm_add_ps(_mm_loadu_ps(cx + x),
+                                  _mm_mul_ps(vWeight, _mm_min_ps(vEdgeY, _mm_loadu_ps(ex + x))));
+            __m128i r = _mm_and_si128(_mm_cvttps_epi32(_mm_add_ps(vr0, _mm_mul_ps(vdr, t))), low);
+            __m128i g = _mm_and_si128(_mm_cvttps_epi32(_mm_add_ps(vg0, _mm_mul_ps(vdg, t))), low);
+            __m128i b = _mm_and_si128(_mm_cvttps_epi32(_mm_add_ps(vb0, _mm_mul_ps(vdb, t))), low);
+            __m128i a = _mm_cvttps_epi32(_mm_add_ps(va0, _mm_mul_ps(vda, t)));
+            __m128i px = _mm_or_si128(_mm_or_si128(r, _mm_slli_epi32(g, 8)),
+                                      _mm_or_si128(_mm_slli_epi32(b, 16), _mm_slli_epi32(a, 24)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x * 4), px);
+        }
+#endif
+        for (; x < n; ++x) {
+            float t = cx[x] + edgeWeight * std::min(edgeY, ex[x]);
+            out[x * 4 + 0] = static_cast<std::uint8_t>(static_cast<int>(r0 + dr * t));
+            out[x * 4 + 1] = static_cast<std::uint8_t>(static_cast<int>(g0 + dg * t));
+            out[x * 4 + 2] = static_cast<std::uint8_t>(static_cast<int>(b0 + db * t));
+            out[x * 4 + 3] = static_cast<std::uint8_t>(static_cast<int>(a0 + da * t));
+        }
+    };
+
+    // Строки идут пачками, чтобы накладные расходы пула не съели выигрыш
+    const std::size_t kRowsPerTask = 16;
+    const std::size_t tasks = (h + kRowsPerTask - 1) / kRowsPerTask;
+    auto block = [&](std::size_t i, unsigned) {
+        std::size_t end = std::min<std::size_t>(h, (i + 1) * kRowsPerTask);
+        for (std::size_t y = i * kRowsPerTask; y < end; ++y)
+            row(y);
+    };
+
+    if (pool)
+        pool->parallelFor(tasks, block);
+    else
+        for (std::size_t i = 0; i < tasks; ++i)
+            block(i, 0);
+    return rgba;
+}
+
+bool loadClothCache(const std::string& cacheDir, const ClothParams& params, std::vector<std::uint8_t>& rgba) {
+    std::ifstream in(cachePath(cacheDir, params), std::ios::binary);
+    if (!in)
+        return false;
+
+    CacheHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        return false;
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kClothVersion ||
+        header.width != params.width || header.height != params.height || header.key != params.key())
+        return false;
+
+    std::vector<std::uint8_t> data(static_cast<std::size_t>(params.width) * params.height * 4);
+    if (!in.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size())))
+        return false;
+    rgba = std::move(data);
+    return true;
+}
+
+bool saveClothCache(const std::string& cacheDir, const ClothParams& params, const std::vector<std::uint8_t>& rgba) {
+    std::error_code ec;
+    std::filesystem::create_directories(cacheDir, ec);
+    if (ec)
+        return false;
+
+    // Пишем во временный файл и переименовываем: оборванная запись не оставит битый кэш
+    std::string path = cachePath(cacheDir, params);
+    std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out)
+            return false;
+        CacheHeader header{};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kClothVersion;
+        header.width = params.width;
+        header.height = params.height;
+        header.key = params.key();
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(rgba.data()), static_cast<std::streamsize>(rgba.size()));
+        if (!out)
+            return false;
+    }
+    std::filesystem::rename(tmp, path, ec);
+    return !ec;
+}
+
+std::vector<std::uint8_t> loadOrGenerateCloth(const std::string& cacheDir, const ClothParams& params,
+                                              WorkStealingPool* pool) {
+    std::vector<std::uint8_t> rgba;
+    if (loadClothCache(cacheDir, params, rgba))
+        return rgba;
+    rgba = generateCloth(params, pool);
+    saveClothCache(cacheDir, params, rgba);
+    return rgba;
+}
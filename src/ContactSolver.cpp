@@ -0,0 +1,189 @@
+#include "ContactSolver.hpp"
+#include <algorithm>
+#include <cmath>
+#include "WorkStealingPool.hpp"
+
+namespace {
+
+std::uint64_t pairKey(std::uint32_t lo, std::uint32_t hi) {
+    return (static_cast<std::uint64_t>(lo) << 32) | hi;
+}
+
+void touch(BallStore& balls, std::uint32_t i) {
+    balls.flags[i] |= kBallTouched;
+}
+
+} // namespace
+
+std::uint32_t ContactSolver::find(std::uint32_t i) {
+    while (parent_[i] != i) {
+        parent_[i] = parent_[parent_[i]];
+        i = parent_[i];
+    }
+    return i;
+}
+
+void ContactSolver::solve(BallStore& balls, const std::vector<UniformGrid::Pair>& candidates, float restitution) {
+    contacts_.clear();
+    for (auto [i, j] : candidates) {
+        float dx = balls.x[j] - balls.x[i];
+        float dy = balls.y[j] - balls.y[i];
+        float dist = std::hypot(dx, dy);
+        float r = balls.radius[i] + balls.radius[j];
+        if (!(dist > 0.f && dist < r))
+            continue;
+        // Направление контакта не зависит от того, кто из двоих раньше в массиве
+        auto ni = static_cast<std::uint32_t>(balls.number[i]);
+        auto nj = static_cast<std::uint32_t>(balls.number[j]);
+        if (nj < ni || (nj == ni && balls.id[j] < balls.id[i])) {
+            std::swap(i, j);
+            std::swap(ni, nj);
+            dx = -dx;
+            dy = -dy;
+        }
+        Contact c{};
+        c.a = i;
+        c.b = j;
+        c.order = pairKey(ni, nj);
+        c.key = pairKey(balls.id[i], balls.id[j]);
+        c.nx = dx / dist;
+        c.ny = dy / dist;
+        contacts_.push_back(c);
+    }
+    stats_.contacts = contacts_.size();
+    stats_.islands = 0;
+    stats_.iterations = 0;
+    if (contacts_.empty()) {
+        cache_.clear();
+        return;
+    }
+
+    // Острова: union-find по индексам шаров
+    parent_.resize(balls.size());
+    for (const Contact& c : contacts_) {
+        parent_[c.a] = c.a;
+        parent_[c.b] = c.b;
+    }
+    for (const Contact& c : contacts_) {
+        std::uint32_t ra = find(c.a), rb = find(c.b);
+        if (ra != rb)
+            parent_[std::max(ra, rb)] = std::min(ra, rb);
+    }
+
+    // Warm start: импульс того же контакта с прошлого подшага, если нормаль почти та же
+    for (Contact& c : contacts_) {
+        c.island = find(c.a);
+        auto it = std::lower_bound(cache_.begin(), cache_.end(), c.key,
+                                   [](const Cached& e, std::uint64_t key) { return e.key < key; });
+        if (it != cache_.end() && it->key == c.key && it->nx * c.nx + it->ny * c.ny > kWarmNormal)
+            c.impulse = it->impulse;
+    }
+
+    // Острова подряд, внутри — канонический порядок. Какой остров раньше — неважно
+    std::sort(contacts_.begin(), contacts_.end(), [](const Contact& l, const Contact& r) {
+        if (l.island != r.island)
+            return l.island < r.island;
+        return l.order != r.order ? l.order < r.order : l.key < r.key;
+    });
+    islandStart_.clear();
+    for (std::size_t k = 0; k < contacts_.size(); ++k)
+        if (k == 0 || contacts_[k].island != contacts_[k - 1].island)
+            islandStart_.push_back(k);
+    islandStart_.push_back(contacts_.size());
+    const std::size_t islands = islandStart_.size() - 1;
+    islandIterations_.assign(islands, 0);
+
+    // Острова не делят шаров — потоки пишут в разные элементы массивов
+    if (pool_ && islands > 1 && contacts_.size() >= kParallelContacts) {
+        pool_->parallelFor(islands, [&](std::size_t k, unsigned) {
+            islandIterations_[k] = solveIsland(balls, islandStart_[k], islandStart_[k + 1], restitution);
+        });
+    } else {
+        for (std::size_t k = 0; k < islands; ++k)
+            islandIterations_[k] = solveIsland(balls, islandStart_[k], islandStart_[k + 1], restitution);
+    }
+
+    next_.clear();
+    for (const Contact& c : contacts_)
+        if (c.impulse > 0.f)
+            next_.push_back({c.key, c.impulse, c.nx, c.ny});
+    std::sort(next_.begin(), next_.end(), [](const Cached& l, const Cached& r) { return l.key < r.key; });
+    cache_.swap(next_);
+
+    stats_.islands = islands;
+    stats_.iterations = *std::max_element(islandIterations_.begin(), islandIterations_.end());
+    ++stats_.solves;
+    stats_.totalIterations += static_cast<std::uint64_t>(stats_.iterations);
+}
+
+int ContactSolver::solveIsland(BallStore& balls, std::size_t begin, std::size_t end, float restitution) {
+    // Массы равны: эффективная масса контакта — 1/2
+    Contact* const first = contacts_.data() + begin;
+    Contact* const last = contacts_.data() + end;
+    auto apply = [&balls](const Contact& c, float impulse) {
+        balls.vx[c.a] -= impulse * c.nx;
+        balls.vy[c.a] -= impulse * c.ny;
+        balls.vx[c.b] += impulse * c.nx;
+        balls.vy[c.b] += impulse * c.ny;
+    };
+    auto normalSpeed = [&balls](const Contact& c) {
+        return (balls.vx[c.b] - balls.vx[c.a]) * c.nx + (balls.vy[c.b] - balls.vy[c.a]) * c.ny;
+    };
+
+    // Цель — по скоростям до warm start
+    for (Contact* c = first; c != last; ++c) {
+        float vn = normalSpeed(*c);
+        c->target = vn < -kBounceSpeed ? -restitution * vn : 0.f;
+    }
+    for (Contact* c = first; c != last; ++c)
+        if (c->impulse > 0.f)
+            apply(*c, c->impulse);
+
+    int iterations = 0;
+    while (iterations < kVelocityIterations) {
+        ++iterations;
+        float change = 0.f;
+        for (Contact* c = first; c != last; ++c) {
+            float delta = 0.5f * (c->target - normalSpeed(*c));
+            float impulse = std::max(c->impulse + delta, 0.f);
+            delta = impulse - c->impulse;
+            c->impulse = impulse;
+            apply(*c, delta);
+            change = std::max(change, std::fabs(delta));
+        }
+        if (change <= kTolerance)
+            break;
+    }
+
+    for (Contact* c = first; c != last; ++c) {
+        if (c->impulse > 0.f) {
+            touch(balls, c->a);
+            touch(balls, c->b);
+        }
+    }
+
+    // Перекрытия: позиции по текущей нормали, скорости не трогаются. Разводим
+    // до половины kSlop, чтобы после прохода шар не остался на самой границе
+    for (int pass = 0; pass < kPositionIterations; ++pass) {
+        bool moved = false;
+        for (Contact* c = first; c != last; ++c) {
+            float dx = balls.x[c->b] - balls.x[c->a];
+            float dy = balls.y[c->b] - balls.y[c->a];
+            float dist = std::hypot(dx, dy);
+            float depth = balls.radius[c->a] + balls.radius[c->b] - dist;
+            if (!(depth > kSlop && dist > 0.f))
+                continue;
+            float shift = 0.5f * kPositionFactor * (depth - 0.5f * kSlop) / dist;
+            balls.x[c->a] -= dx * shift;
+            balls.y[c->a] -= dy * shift;
+            balls.x[c->b] += dx * shift;
+            balls.y[c->b] += dy * shift;
+            touch(balls, c->a);
+            touch(balls, c->b);
+            moved = true;
+        }
+        if (!moved)
+            break;
+    }
+    return iterations;
+}
@@ -2,33 +2,40 @@
 #include <cmath>
 
 Cue::Cue()
-    : length_(150.f), power_(0.f), visible_(true)
+    : direction_(1.f, 0.f), visible_(false)
 {
-    shape_.setSize(sf::Vector2f(length_, 6.f));
-    shape_.setOrigin(0.f, 3.f); // Левый край — начало кия
-    shape_.setFillColor(sf::Color(160, 110, 60));
-    shape_.setOutlineColor(sf::Color(80, 60, 30));
-    shape_.setOutlineThickness(1.f);
-    direction_ = {1.f, 0.f};
 }
 
-void Cue::update(sf::Vector2f cueStart, sf::Vector2f cueEnd, float power, bool visible)
+void Cue::update(sf::Vector2f start, sf::Vector2f end, float length, bool visible)
 {
-    sf::Vector2f dir = cueEnd - cueStart;
-    float len = std::hypot(dir.x, dir.y);
-    direction_ = (len > 1e-2f) ? dir / len : sf::Vector2f{1, 0};
-    power_ = power;
     visible_ = visible;
+    if (!visible_)
+        return;
+
+    sf::Vector2f dir = end - start;
+    float len = std::hypot(dir.x, dir.y);
+    if (len > 1e-2f)
+        direction_ = dir / len;
 
-    shape_.setPosition(cueStart);
-    float angle = std::atan2(direction_.y, direction_.x) * 180 / 3.1415926f;
-    shape_.setRotation(angle);
-    float cueLen = std::clamp(power_, 10.f, 200.f);
-    shape_.setSize(sf::Vector2f(cueLen, 5.f));
+    sf::Vector2f shadow(3.f, 5.f);
+    sf::Color shadowColor(25, 30, 20, 60);
+    setQuad(0, start + shadow, start + shadow + direction_ * length, shadowColor, shadowColor);
+    setQuad(6, start, start + direction_ * length, sf::Color(210, 170, 80), sf::Color(110, 65, 20));
+    setQuad(12, end - direction_ * kTipLength, end, sf::Color(62, 38, 20), sf::Color(62, 38, 20));
 }
 
-void Cue::draw(sf::RenderWindow& window) const
+void Cue::draw(sf::RenderTarget& target) const
 {
     if (visible_)
-        window.draw(shape_);
+        target.draw(vertices_.data(), vertices_.size(), sf::Triangles);
+}
+
+void Cue::setQuad(std::size_t first, sf::Vector2f from, sf::Vector2f to, sf::Color cFrom, sf::Color cTo)
+{
+    sf::Vector2f n(-direction_.y * kWidth / 2.f, direction_.x * kWidth / 2.f);
+    sf::Vertex a(from - n, cFrom), b(from + n, cFrom);
+    sf::Vertex c(to - n, cTo), d(to + n, cTo);
+    sf::Vertex* v = &vertices_[first];
+    v[0] = a; v[1] = b; v[2] = d;
+    v[3] = a; v[4] = d; v[5] = c;
 }
@@ -0,0 +1,440 @@
+#include "EventSimulation.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// c[0] + c[1]·t + ... + c[deg]·t^deg
+struct Poly {
+    double c[5] = {0, 0, 0, 0, 0};
+    int deg = 0;
+
+    double operator()(double t) const {
+        double r = c[deg];
+        for (int k = deg - 1; k >= 0; --k)
+            r = r * t + c[k];
+        return r;
+    }
+
+    Poly derivative() const {
+        Poly d;
+        d.deg = std::max(deg - 1, 0);
+        for (int k = 1; k <= deg; ++k)
+            d.c[k - 1] = c[k] * k;
+        return d;
+    }
+};
+
+double bisect(const Poly& p, double a, double b) {
+    bool negA = p(a) <= 0.0;
+    for (int it = 0; it < 100 && b - a > 1e-12; ++it) {
+        double m = 0.5 * (a + b);
+        if ((p(m) <= 0.0) == negA)
+            a = m;
+        else
+            b = m;
+    }
+    return b;
+}
+
+// Все вещественные корни на (lo, hi) по возрастанию: между корнями
+// производной функция монотонна, и каждый корень ищется делением пополам
+int realRoots(const Poly& p, double lo, double hi, double* out) {
+    if (p.deg == 0)
+        return 0;
+    if (p.deg == 1) {
+        if (p.c[1] == 0.0)
+            return 0;
+        double r = -p.c[0] / p.c[1];
+        if (r > lo && r < hi) {
+            out[0] = r;
+            return 1;
+        }
+        return 0;
+    }
+    if (p.deg == 2 && p.c[2] != 0.0) {
+        double disc = p.c[1] * p.c[1] - 4.0 * p.c[2] * p.c[0];
+        if (disc < 0.0)
+            return 0;
+        double q = -0.5 * (p.c[1] + std::copysign(std::sqrt(disc), p.c[1]));
+        double r1 = q / p.c[2];
+        double r2 = q != 0.0 ? p.c[0] / q : r1;
+        if (r1 > r2)
+            std::swap(r1, r2);
+        int count = 0;
+        if (r1 > lo && r1 < hi)
+            out[count++] = r1;
+        if (r2 > lo && r2 < hi && r2 != r1)
+            out[count++] = r2;
+        return count;
+    }
+
+    double pts[6];
+    int n = 0;
+    pts[n++] = lo;
+    n += realRoots(p.derivative(), lo, hi, pts + n);
+    pts[n++] = hi;
+
+    int count = 0;
+    for (int k = 0; k + 1 < n; ++k) {
+        double fa = p(pts[k]), fb = p(pts[k + 1]);
+        if ((fa <= 0.0) != (fb <= 0.0))
+            out[count++] = bisect(p, pts[k], pts[k + 1]);
+    }
+    return count;
+}
+
+// Первый момент на [lo, hi], когда f переходит из положительной области в f <= 0.
+// Если уже f(lo) <= 0, событие наступает сразу, только когда f убывает быстрее minSlope.
+bool firstEntering(const Poly& f, double lo, double hi, double& t, double minSlope) {
+    if (hi < lo)
+        return false;
+    if (f(lo) <= 0.0 && f.derivative()(lo) < -minSlope) {
+        t = lo;
+        return true;
+    }
+
+    double pts[6];
+    int n = 0;
+    pts[n++] = lo;
+    n += realRoots(f.derivative(), lo, hi, pts + n);
+    pts[n++] = hi;
+    for (int k = 0; k + 1 < n; ++k) {
+        if (f(pts[k]) > 0.0 && f(pts[k + 1]) <= 0.0) {
+            t = bisect(f, pts[k], pts[k + 1]);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Координата шара на отрезке: либо парабола (катится), либо константа (стоит)
+struct Track {
+    Poly x, y;
+};
+
+Poly square(const Poly& a) {
+    Poly r;
+    r.deg = a.deg * 2;
+    for (int i = 0; i <= a.deg; ++i)
+        for (int j = 0; j <= a.deg; ++j)
+            r.c[i + j] += a.c[i] * a.c[j];
+    return r;
+}
+
+Poly sub(const Poly& a, const Poly& b) {
+    Poly r;
+    r.deg = std::max(a.deg, b.deg);
+    for (int k = 0; k <= r.deg; ++k)
+        r.c[k] = a.c[k] - b.c[k];
+    return r;
+}
+
+Poly constant(double v) {
+    Poly p;
+    p.c[0] = v;
+    return p;
+}
+
+} // namespace
+
+EventSimulation::EventSimulation(const Simulation& sim)
+    : EventSimulation(sim.table(), sim.balls(), sim.params()) {}
+
+EventSimulation::EventSimulation(const TableGeometry& table, const BallStore& balls, const PhysicsParams& params)
+    : table_(table), balls_(balls), params_(params),
+      decel_(static_cast<double>(params.mu) * params.gravity)
+{
+    init();
+}
+
+void EventSimulation::init() {
+    motion_.resize(balls_.size());
+    for (std::size_t i = 0; i < balls_.size(); ++i) {
+        motion_[i] = {balls_.x[i], balls_.y[i], balls_.vx[i], balls_.vy[i], 0.0};
+        settle(motion_[i]);
+    }
+    for (std::size_t i = 0; i < balls_.size(); ++i)
+        predict(i);
+}
+
+EventSimulation::Motion EventSimulation::stateAt(std::size_t i, double t) const {
+    Motion m = motion_[i];
+    double speed = std::hypot(m.vx, m.vy);
+    double tau = t - m.t0;
+    if (tau <= 0.0)
+        return m;
+    m.t0 = t;
+    if (speed == 0.0)
+        return m;
+
+    double ux = m.vx / speed, uy = m.vy / speed;
+    double stop = speed / decel_;
+    if (tau >= stop) {
+        double dist = speed * speed / (2.0 * decel_);
+        m.x += ux * dist;
+        m.y += uy * dist;
+        m.vx = m.vy = 0.0;
+    } else {
+        m.x += m.vx * tau - 0.5 * decel_ * ux * tau * tau;
+        m.y += m.vy * tau - 0.5 * decel_ * uy * tau * tau;
+        m.vx -= decel_ * ux * tau;
+        m.vy -= decel_ * uy * tau;
+    }
+    return m;
+}
+
+void EventSimulation::sync(std::size_t i, double t) {
+    motion_[i] = stateAt(i, t);
+}
+
+void EventSimulation::settle(Motion& m) const {
+    if (std::hypot(m.vx, m.vy) < kMinSpeed)
+        m.vx = m.vy = 0.0;
+}
+
+bool EventSimulation::isNearPocket(double x, double y) const {
+    for (const auto& p : table_.pockets)
+        if (std::hypot(x - p.x, y - p.y) < p.radius * params_.pocketMargin)
+            return true;
+    return false;
+}
+
+void EventSimulation::push(double t, EventType type, std::size_t i, std::size_t j, int side) {
+    queue_.push({t, type,
+                 static_cast<std::uint32_t>(i), static_cast<std::uint32_t>(j),
+                 motion_[i].version, motion_[j].version, side});
+}
+
+void EventSimulation::predict(std::size_t i) {
+    const Motion& m = motion_[i];
+    if (!m.active)
+        return;
+
+    const double r = balls_.radius[i];
+    const double speed = std::hypot(m.vx, m.vy);
+    const double stop = speed > 0.0 ? speed / decel_ : 0.0;
+
+    Track path;
+    path.x.deg = path.y.deg = 2;
+    path.x.c[0] = m.x;
+    path.y.c[0] = m.y;
+    if (speed > 0.0) {
+        path.x.c[1] = m.vx;
+        path.y.c[1] = m.vy;
+        path.x.c[2] = -0.5 * decel_ * m.vx / speed;
+        path.y.c[2] = -0.5 * decel_ * m.vy / speed;
+        push(now_ + stop, EventType::Stop, i, i, 0);
+    }
+
+    double tau;
+    for (std::size_t k = 0; k < table_.pockets.size(); ++k) {
+        const auto& p = table_.pockets[k];
+        Poly d2 = square(sub(path.x, constant(p.x)));
+        Poly dy2 = square(sub(path.y, constant(p.y)));
+        for (int c = 0; c <= 4; ++c)
+            d2.c[c] += dy2.c[c];
+
+        double capture = p.radius - r * params_.captureDepth;
+        Poly fall = sub(d2, constant(capture * capture));
+        if (fall(0.0) <= 0.0)
+            push(now_, EventType::Pocket, i, i, static_cast<int>(k));
+        else if (speed > 0.0 && firstEntering(fall, 0.0, stop, tau, 0.0))
+            push(now_ + tau, EventType::Pocket, i, i, static_cast<int>(k));
+
+        double zone = p.radius * params_.pocketMargin;
+        if (speed > 0.0 && d2(0.0) < zone * zone) {
+            Poly leave = sub(constant(zone * zone), d2);
+            if (firstEntering(leave, 0.0, stop, tau, 2.0 * zone * kMinSpeed))
+                push(now_ + tau, EventType::PocketZoneExit, i, i, static_cast<int>(k));
+        }
+    }
+
+    if (speed > 0.0 && !isNearPocket(m.x, m.y)) {
+        const double right = table_.left + table_.width;
+        const double bottom = table_.top + table_.height;
+        const Poly gaps[4] = {
+            sub(path.x, constant(table_.left + r)),
+            sub(constant(right - r), path.x),
+            sub(path.y, constant(table_.top + r)),
+            sub(constant(bottom - r), path.y),
+        };
+        for (int side = 0; side < 4; ++side)
+            if (firstEntering(gaps[side], 0.0, stop, tau, kMinSpeed))
+                push(now_ + tau, EventType::Cushion, i, i, side);
+    }
+
+    for (std::size_t j = 0; j < motion_.size(); ++j)
+        if (j != i && motion_[j].active)
+            predictPair(i, j);
+}
+
+void EventSimulation::predictPair(std::size_t i, std::size_t j) {
+    const Motion a = stateAt(i, now_);
+    const Motion b = stateAt(j, now_);
+    const double speedA = std::hypot(a.vx, a.vy);
+    const double speedB = std::hypot(b.vx, b.vy);
+    if (speedA == 0.0 && speedB == 0.0)
+        return;
+
+    const double stopA = speedA / decel_;
+    const double stopB = speedB / decel_;
+    const double R = balls_.radius[i] + balls_.radius[j];
+
+    // Тормозные пути не дотягиваются друг до друга — корни можно не искать
+    double reach = (speedA * speedA + speedB * speedB) / (2.0 * decel_);
+    if (std::hypot(b.x - a.x, b.y - a.y) - R > reach)
+        return;
+
+    // На отрезке [s0, s1] каждый шар либо катится по параболе, либо уже стоит
+    auto track = [this](const Motion& m, double speed, double stop, double s1) {
+        Track t;
+        t.x.deg = t.y.deg = 2;
+        if (speed > 0.0 && stop >= s1) {
+            t.x.c[0] = m.x;  t.x.c[1] = m.vx;  t.x.c[2] = -0.5 * decel_ * m.vx / speed;
+            t.y.c[0] = m.y;  t.y.c[1] = m.vy;  t.y.c[2] = -0.5 * decel_ * m.vy / speed;
+        } else {
+            double dist = speed > 0.0 ? speed * speed / (2.0 * decel_) : 0.0;
+            t.x.c[0] = m.x + (speed > 0.0 ? m.vx / speed * dist : 0.0);
+            t.y.c[0] = m.y + (speed > 0.0 ? m.vy / speed * dist : 0.0);
+        }
+        return t;
+    };
+
+    const double breaks[3] = {0.0, std::min(stopA, stopB), std::max(stopA, stopB)};
+    for (int s = 0; s < 2; ++s) {
+        double s0 = breaks[s], s1 = breaks[s + 1];
+        if (s1 <= s0 && s > 0)
+            continue;
+        Track ta = track(a, speedA, stopA, s1);
+        Track tb = track(b, speedB, stopB, s1);
+        Poly f = square(sub(tb.x, ta.x));
+        Poly fy = square(sub(tb.y, ta.y));
+        for (int c = 0; c <= 4; ++c)
+            f.c[c] += fy.c[c];
+        f.c[0] -= R * R;
+
+        double tau;
+        // f' = 2·D·ΔV ≈ 2R·(скорость сближения по нормали)
+        if (firstEntering(f, s0, s1, tau, 2.0 * R * kMinSpeed)) {
+            push(now_ + tau, EventType::Ball, i, j, 0);
+            return;
+        }
+    }
+}
+
+void EventSimulation::process(const Event& e) {
+    switch (e.type) {
+    case EventType::Stop:
+        // Остановка уже учтена в прогнозах: достаточно зафиксировать состояние
+        sync(e.i, e.t);
+        return;
+
+    case EventType::PocketZoneExit:
+        sync(e.i, e.t);
+        ++motion_[e.i].version;
+        predict(e.i);
+        return;
+
+    case EventType::Cushion: {
+        sync(e.i, e.t);
+        Motion& m = motion_[e.i];
+        if (!isNearPocket(m.x, m.y)) { // В области лузы не отражаем!
+            if (e.side < 2)
+                m.vx = -m.vx * params_.cushion;
+            else
+                m.vy = -m.vy * params_.cushion;
+        }
+        settle(m);
+        ++m.version;
+        predict(e.i);
+        return;
+    }
+
+    case EventType::Pocket:
+        sync(e.i, e.t);
+        motion_[e.i].active = false;
+        ++motion_[e.i].version;
+        pocketed_.push_back(balls_.number[e.i]);
+        return;
+
+    case EventType::Ball: {
+        sync(e.i, e.t);
+        sync(e.j, e.t);
+        Motion& a = motion_[e.i];
+        Motion& b = motion_[e.j];
+        double dx = b.x - a.x, dy = b.y - a.y;
+        double dist = std::hypot(dx, dy);
+        if (dist > 0.0) {
+            double nx = dx / dist, ny = dy / dist;
+            double vA = a.vx * nx + a.vy * ny;
+            double vB = b.vx * nx + b.vy * ny;
+            if (vA - vB > 0.0) {
+                // Импульс только по нормали, как у ContactSolver; медленное касание не отскакивает
+                const double e = vA - vB > ContactSolver::kBounceSpeed ? params_.restitution : 0.0;
+                double p = 0.5 * (1.0 + e) * (vA - vB); // равные массы
+                a.vx -= p * nx;
+                a.vy -= p * ny;
+                b.vx += p * nx;
+                b.vy += p * ny;
+            }
+        }
+        settle(a);
+        settle(b);
+        ++a.version;
+        ++b.version;
+        predict(e.i);
+        predict(e.j);
+        return;
+    }
+    }
+}
+
+void EventSimulation::advanceTo(double t) {
+    while (!queue_.empty() && queue_.top().t <= t) {
+        Event e = queue_.top();
+        queue_.pop();
+        const Motion& a = motion_[e.i];
+        const Motion& b = motion_[e.j];
+        if (!a.active || a.version != e.vi || !b.active || b.version != e.vj)
+            continue;
+        now_ = e.t;
+        process(e);
+    }
+    now_ = std::max(now_, t);
+}
+
+int EventSimulation::simulateUntilRest(std::vector<int>* pocketed, int maxEvents) {
+    std::size_t firstNew = pocketed_.size();
+    int processed = 0;
+    while (!queue_.empty() && processed < maxEvents) {
+        Event e = queue_.top();
+        queue_.pop();
+        const Motion& a = motion_[e.i];
+        const Motion& b = motion_[e.j];
+        if (!a.active || a.version != e.vi || !b.active || b.version != e.vj)
+            continue;
+        now_ = e.t;
+        process(e);
+        ++processed;
+    }
+    if (pocketed)
+        pocketed->insert(pocketed->end(), pocketed_.begin() + firstNew, pocketed_.end());
+    return processed;
+}
+
+BallStore EventSimulation::balls() const {
+    BallStore out = balls_;
+    for (std::size_t i = 0; i < motion_.size(); ++i) {
+        Motion m = stateAt(i, now_);
+        out.x[i] = static_cast<float>(m.x);
+        out.y[i] = static_cast<float>(m.y);
+        out.setVelocity(i, static_cast<float>(m.vx), static_cast<float>(m.vy));
+        if (out.vx[i] == 0.f && out.vy[i] == 0.f)
+            out.sleep(i);
+    }
+    for (std::size_t i = motion_.size(); i-- > 0;)
+        if (!motion_[i].active)
+            out.erase(i);
+    return out;
+}
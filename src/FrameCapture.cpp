@@ -0,0 +1,199 @@
+#include "FrameCapture.hpp"
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+
+namespace {
+
+constexpr char kFrameTag[] = "FRAME\n";
+constexpr std::size_t kFrameTagSize = sizeof(kFrameTag) - 1;
+
+bool seek(std::FILE* file, std::uint64_t offset) {
+#if defined(_WIN32)
+    return _fseeki64(file, static_cast<long long>(offset), SEEK_SET) == 0;
+#else
+    return fseeko(file, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+}
+
+// RGBA → YUV 4:2:0, BT.601 в полном диапазоне (C420jpeg): яркость на пиксель,
+// цвет — среднее квадрата 2x2
+void toYuv420(const std::uint8_t* rgba, unsigned w, unsigned h, std::uint8_t* out) {
+    std::uint8_t* yPlane = out;
+    std::uint8_t* uPlane = yPlane + static_cast<std::size_t>(w) * h;
+    std::uint8_t* vPlane = uPlane + static_cast<std::size_t>(w / 2) * (h / 2);
+    for (unsigned y = 0; y < h; y += 2) {
+        const std::uint8_t* row0 = rgba + static_cast<std::size_t>(y) * w * 4;
+        const std::uint8_t* row1 = row0 + static_cast<std::size_t>(w) * 4;
+        std::uint8_t* y0 = yPlane + static_cast<std::size_t>(y) * w;
+        std::uint8_t* y1 = y0 + w;
+        std::size_t c = static_cast<std::size_t>(y / 2) * (w / 2);
+        for (unsigned x = 0; x < w; x += 2, ++c) {
+            int r = 0, g = 0, b = 0;
+            for (unsigned k = 0; k < 2; ++k) {
+                const std::uint8_t* p0 = row0 + (x + k) * 4;
+                const std::uint8_t* p1 = row1 + (x + k) * 4;
+                y0[x + k] = static_cast<std::uint8_t>((77 * p0[0] + 150 * p0[1] + 29 * p0[2] + 128) >> 8);
+                y1[x + k] = static_cast<std::uint8_t>((77 * p1[0] + 150 * p1[1] + 29 * p1[2] + 128) >> 8);
+                r += p0[0] + p1[0];
+                g += p0[1] + p1[1];
+                b += p0[2] + p1[2];
+            }
+            int u = (-43 * r - 85 * g + 128 * b + 512 + (128 << 10)) >> 10;
+            int v = (128 * r - 107 * g - 21 * b + 512 + (128 << 10)) >> 10;
+            uPlane[c] = static_cast<std::uint8_t>(std::min(u, 255));
+            vPlane[c] = static_cast<std::uint8_t>(std::min(v, 255));
+        }
+    }
+}
+
+} // namespace
+
+FrameCapture::FrameCapture(const Options& options)
+    : options_(options)
+{
+    const unsigned w = options_.width, h = options_.height;
+    frameBytes_ = static_cast<std::size_t>(w) * h * 4;
+    if (w == 0 || h == 0) {
+        error_ = "empty frame size";
+        return;
+    }
+
+    std::error_code ec;
+    if (options_.format == Format::Y4m) {
+        if (w % 2 || h % 2) {
+            error_ = "y4m needs even frame size";
+            return;
+        }
+        std::filesystem::path dir = std::filesystem::path(options_.path).parent_path();
+        if (!dir.empty())
+            std::filesystem::create_directories(dir, ec);
+        char header[96];
+        int length = std::snprintf(header, sizeof(header), "YUV4MPEG2 W%u H%u F%u:1 Ip A1:1 C420jpeg\n",
+                                   w, h, options_.fps);
+        std::FILE* file = std::fopen(options_.path.c_str(), "wb");
+        if (!file || std::fwrite(header, 1, static_cast<std::size_t>(length), file) != static_cast<std::size_t>(length)) {
+            error_ = "cannot write " + options_.path;
+            if (file)
+                std::fclose(file);
+            return;
+        }
+        std::fclose(file);
+        y4mHeader_ = static_cast<std::uint64_t>(length);
+    } else {
+        std::filesystem::create_directories(options_.path, ec);
+        if (!std::filesystem::is_directory(options_.path)) {
+            error_ = "cannot create " + options_.path;
+            return;
+        }
+    }
+
+    workers_ = options_.workers;
+    if (workers_ == 0)
+        workers_ = std::max(2u, std::thread::hardware_concurrency()) - 1;
+    std::size_t queue = options_.queueFrames ? options_.queueFrames : 2 * workers_;
+    buffers_.assign(queue, std::vector<std::uint8_t>(frameBytes_));
+    for (std::size_t i = 0; i < queue; ++i)
+        free_.push_back(i);
+    for (unsigned i = 0; i < workers_; ++i)
+        threads_.emplace_back(&FrameCapture::work, this);
+}
+
+FrameCapture::~FrameCapture() {
+    finish();
+}
+
+bool FrameCapture::ok() const {
+    std::lock_guard<std::mutex> lock(m_);
+    return error_.empty();
+}
+
+std::string FrameCapture::error() const {
+    std::lock_guard<std::mutex> lock(m_);
+    return error_;
+}
+
+void FrameCapture::push(const std::uint8_t* rgba) {
+    if (threads_.empty())
+        return;
+    std::unique_lock<std::mutex> lock(m_);
+    if (free_.empty()) {
+        auto t0 = std::chrono::steady_clock::now();
+        done_.wait(lock, [&] { return !free_.empty(); });
+        stallSeconds_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    }
+    std::size_t buffer = free_.back();
+    free_.pop_back();
+    lock.unlock();
+
+    // Копия вне блокировки: рабочие в это время продолжают кодировать
+    std::memcpy(buffers_[buffer].data(), rgba, frameBytes_);
+
+    lock.lock();
+    jobs_.push_back({next_++, buffer});
+    lock.unlock();
+    work_.notify_one();
+}
+
+bool FrameCapture::finish() {
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        stop_ = true;
+    }
+    work_.notify_all();
+    for (std::thread& t : threads_)
+        t.join();
+    threads_.clear();
+    return ok();
+}
+
+void FrameCapture::work() {
+    std::vector<std::uint8_t> yuv;
+    std::FILE* file = nullptr;
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_);
+            work_.wait(lock, [&] { return stop_ || !jobs_.empty(); });
+            if (jobs_.empty())
+                break;
+            job = jobs_.front();
+            jobs_.pop_front();
+        }
+
+        bool written = options_.format == Format::Y4m ? writeY4m(job, yuv, file) : writePng(job);
+
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            free_.push_back(job.buffer);
+            if (!written && error_.empty())
+                error_ = "cannot write frame " + std::to_string(job.index) + " to " + options_.path;
+        }
+        done_.notify_one();
+    }
+    if (file)
+        std::fclose(file);
+}
+
+bool FrameCapture::writeY4m(const Job& job, std::vector<std::uint8_t>& yuv, std::FILE*& file) const {
+    const unsigned w = options_.width, h = options_.height;
+    const std::size_t planes = static_cast<std::size_t>(w) * h * 3 / 2;
+    yuv.resize(kFrameTagSize + planes);
+    std::memcpy(yuv.data(), kFrameTag, kFrameTagSize);
+    toYuv420(buffers_[job.buffer].data(), w, h, yuv.data() + kFrameTagSize);
+
+    if (!file)
+        file = std::fopen(options_.path.c_str(), "r+b");
+    return file && seek(file, y4mHeader_ + job.index * yuv.size()) &&
+           std::fwrite(yuv.data(), 1, yuv.size(), file) == yuv.size() && std::fflush(file) == 0;
+}
+
+bool FrameCapture::writePng(const Job& job) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "frame_%06llu.png", static_cast<unsigned long long>(job.index));
+    sf::Image image;
+    image.create(options_.width, options_.height, buffers_[job.buffer].data());
+    return image.saveToFile((std::filesystem::path(options_.path) / name).string());
+}
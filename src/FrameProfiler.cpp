@@ -0,0 +1,165 @@
+#include "FrameProfiler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+constexpr const char* kPhaseNames[] = {
+    "picking", "input", "physics", "pockets", "animation", "draw", "hud", "present", "frame"
+};
+static_assert(sizeof(kPhaseNames) / sizeof(kPhaseNames[0]) == FrameProfiler::kPhases);
+
+double percentileOfSorted(const std::vector<float>& v, double q) {
+    return v.empty() ? 0.0 : v[static_cast<std::size_t>(q * (v.size() - 1) + 0.5)];
+}
+
+} // namespace
+
+int FrameProfiler::bucketOf(double us) {
+    if (!(us > 1.0 / 8.0))
+        return 0;
+    int b = static_cast<int>(std::log2(us * 8.0) * kBucketsPerOctave);
+    return std::min(b, kBuckets - 1);
+}
+
+double FrameProfiler::bucketValue(int bucket) {
+    // Середина корзины в геометрическом смысле
+    return std::exp2((bucket + 0.5) / kBucketsPerOctave) / 8.0;
+}
+
+void FrameProfiler::beginFrame() {
+    if (!enabled_)
+        return;
+    inFrame_ = true;
+    current_.fill(0.f);
+    frameStart_ = mark_ = Clock::now();
+}
+
+void FrameProfiler::lapSlow(FramePhase phase) {
+    Clock::time_point now = Clock::now();
+    current_[static_cast<std::size_t>(phase)] += std::chrono::duration<float, std::micro>(now - mark_).count();
+    mark_ = now;
+}
+
+void FrameProfiler::endFrame() {
+    if (!inFrame_)
+        return;
+    inFrame_ = false;
+    if (!enabled_)
+        return;
+    current_[static_cast<std::size_t>(FramePhase::Frame)] =
+        std::chrono::duration<float, std::micro>(Clock::now() - frameStart_).count();
+
+    for (std::size_t p = 0; p < kPhases; ++p) {
+        ++histogram_[p][bucketOf(current_[p])];
+        sum_[p] += current_[p];
+        max_[p] = std::max(max_[p], static_cast<double>(current_[p]));
+    }
+    if (ring_.size() < kWindow) {
+        ring_.push_back(current_);
+    } else {
+        ring_[ringNext_] = current_;
+        ringNext_ = (ringNext_ + 1) % kWindow;
+    }
+    ++frames_;
+}
+
+PhaseStats FrameProfiler::recent(FramePhase phase) const {
+    std::size_t p = static_cast<std::size_t>(phase);
+    std::vector<float> v;
+    v.reserve(ring_.size());
+    double sum = 0;
+    for (const auto& frame : ring_) {
+        v.push_back(frame[p]);
+        sum += frame[p];
+    }
+    std::sort(v.begin(), v.end());
+    PhaseStats s;
+    s.count = v.size();
+    if (v.empty())
+        return s;
+    s.p50 = percentileOfSorted(v, 0.5);
+    s.p99 = percentileOfSorted(v, 0.99);
+    s.max = v.back();
+    s.mean = sum / v.size();
+    return s;
+}
+
+PhaseStats FrameProfiler::session(FramePhase phase) const {
+    std::size_t p = static_cast<std::size_t>(phase);
+    PhaseStats s;
+    s.count = frames_;
+    if (frames_ == 0)
+        return s;
+    auto quantile = [&](double q) {
+        std::uint64_t rank = static_cast<std::uint64_t>(q * (frames_ - 1));
+        std::uint64_t seen = 0;
+        for (int b = 0; b < kBuckets; ++b) {
+            seen += histogram_[p][b];
+            if (seen > rank)
+                return std::min(bucketValue(b), max_[p]);
+        }
+        return max_[p];
+    };
+    s.p50 = quantile(0.5);
+    s.p99 = quantile(0.99);
+    s.max = max_[p];
+    s.mean = sum_[p] / frames_;
+    return s;
+}
+
+std::string FrameProfiler::overlayText() const {
+    std::string text = "phase       p50    p99    max  (us)\n";
+    char line[96];
+    for (std::size_t p = 0; p < kPhases; ++p) {
+        PhaseStats s = recent(static_cast<FramePhase>(p));
+        std::snprintf(line, sizeof(line), "%-9s %6.0f %6.0f %6.0f\n", kPhaseNames[p], s.p50, s.p99, s.max);
+        text += line;
+    }
+    if (firstFrameMs_ > 0.0) {
+        std::snprintf(line, sizeof(line), "first frame %.1f ms\n", firstFrameMs_);
+        text += line;
+    }
+    return text;
+}
+
+bool FrameProfiler::writeCsv(const std::string& path) const {
+    FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) {
+        std::perror(path.c_str());
+        return false;
+    }
+    std::fprintf(f, "frame");
+    for (std::size_t p = 0; p < kPhases; ++p)
+        std::fprintf(f, ",%s_us", kPhaseNames[p]);
+    std::fprintf(f, "\n");
+    // От старых кадров к новым; номер — от начала сессии
+    std::uint64_t first = frames_ - ring_.size();
+    for (std::size_t k = 0; k < ring_.size(); ++k) {
+        const auto& frame = ring_[(ringNext_ + k) % ring_.size()];
+        std::fprintf(f, "%llu", static_cast<unsigned long long>(first + k));
+        for (std::size_t p = 0; p < kPhases; ++p)
+            std::fprintf(f, ",%.1f", frame[p]);
+        std::fprintf(f, "\n");
+    }
+    return std::fclose(f) == 0;
+}
+
+bool FrameProfiler::writeJson(const std::string& path) const {
+    FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) {
+        std::perror(path.c_str());
+        return false;
+    }
+    std::fprintf(f, "{\n  \"frames\": %llu,\n  \"first_frame_ms\": %.1f,\n  \"phases\": [\n",
+                 static_cast<unsigned long long>(frames_), firstFrameMs_);
+    for (std::size_t p = 0; p < kPhases; ++p) {
+        PhaseStats s = session(static_cast<FramePhase>(p));
+        std::fprintf(f,
+            "    {\"name\": \"%s\", \"mean_us\": %.1f, \"p50_us\": %.1f, \"p99_us\": %.1f, \"max_us\": %.1f}%s\n",
+            kPhaseNames[p], s.mean, s.p50, s.p99, s.max, p + 1 < kPhases ? "," : "");
+    }
+    std::fprintf(f, "  ]\n}\n");
+    return std::fclose(f) == 0;
+}
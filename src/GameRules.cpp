@@ -0,0 +1,68 @@
+#include "GameRules.hpp"
+
+void GameState::reset(float cueX, float cueY) {
+    score_[0] = score_[1] = 0;
+    player_ = 1;
+    cueX_ = cueX;
+    cueY_ = cueY;
+    inShot_ = false;
+    scored_ = 0;
+    cuePocketed_ = false;
+}
+
+void GameState::beginShot() {
+    inShot_ = true;
+    scored_ = 0;
+    cuePocketed_ = false;
+}
+
+void GameState::onPocket(int ballNumber) {
+    if (ballNumber == 0) {
+        cuePocketed_ = true;
+    } else {
+        ++scored_;
+        ++score_[player_ - 1];
+    }
+}
+
+ShotResult GameState::endShot() {
+    ShotResult r;
+    r.scored = scored_;
+    r.scratch = cuePocketed_;
+    r.respotCue = cuePocketed_;
+    // Забил и не потерял биток — бьёт снова
+    r.turnPassed = cuePocketed_ || scored_ == 0;
+    if (r.turnPassed)
+        player_ = player_ == 1 ? 2 : 1;
+    inShot_ = false;
+    scored_ = 0;
+    cuePocketed_ = false;
+    return r;
+}
+
+void GameState::save(TableState& state) const {
+    state.score[0] = score_[0];
+    state.score[1] = score_[1];
+    state.player = player_;
+    state.cueStartX = cueX_;
+    state.cueStartY = cueY_;
+}
+
+void GameState::load(const TableState& state) {
+    score_[0] = state.score[0];
+    score_[1] = state.score[1];
+    player_ = state.player;
+    cueX_ = state.cueStartX;
+    cueY_ = state.cueStartY;
+    inShot_ = false;
+    scored_ = 0;
+    cuePocketed_ = false;
+}
+
+int GameState::winner() const {
+    if (score_[0] >= rules_.ballsToWin)
+        return 1;
+    if (score_[1] >= rules_.ballsToWin)
+        return 2;
+    return 0;
+}
@@ -0,0 +1,298 @@
+#include "IntegrateKernel.hpp"
+#include "Simulation.hpp"
+#include <cmath>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+// Без сжатия a*b+c в FMA: иначе при -march=native скалярный путь
+// расходится с SIMD в последнем бите
+#if defined(__clang__)
+#pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+namespace {
+
+// Откуда ядро берёт трение, борт и зону лузы: из IntegrateParams (общий шаг)
+// или из профиля — тогда это литералы прямо в коде ядра. Значения те же,
+// так что результат побитово совпадает
+struct RuntimeConstants {
+    static float decel(const IntegrateParams& p)        { return p.decel; }
+    static float cushion(const IntegrateParams& p)      { return p.cushion; }
+    static float pocketMargin(const IntegrateParams& p) { return p.pocketMargin; }
+};
+
+template <class Profile>
+struct ProfileConstants {
+    // mu * g — так же, как Simulation считает decel = mu * g * dt
+    static constexpr float kFriction = Profile::kParams.mu * Profile::kParams.gravity;
+    static float decel(const IntegrateParams& p)                  { return kFriction * p.dt; }
+    static constexpr float cushion(const IntegrateParams&)        { return Profile::kParams.cushion; }
+    static constexpr float pocketMargin(const IntegrateParams&)   { return Profile::kParams.pocketMargin; }
+};
+
+// Один шар; используется и как скалярное ядро, и для хвоста SIMD-циклов
+template <class C>
+inline void integrateOne(BallStore& b, std::size_t i, const IntegrateParams& p) {
+    float x = b.x[i] + b.vx[i] * p.dt;
+    float y = b.y[i] + b.vy[i] * p.dt;
+    float vx = b.vx[i], vy = b.vy[i];
+
+    const float decel = C::decel(p);
+    float speed = std::sqrt(vx * vx + vy * vy);
+    if (speed <= decel) {
+        vx = 0.f;
+        vy = 0.f;
+    } else {
+        vx = vx - vx / speed * decel;
+        vy = vy - vy / speed * decel;
+    }
+
+    bool nearPocket = false;
+    for (std::size_t k = 0; k < p.pocketCount; ++k) {
+        float dx = x - p.pockets[k].x;
+        float dy = y - p.pockets[k].y;
+        float zone = p.pockets[k].radius * C::pocketMargin(p);
+        nearPocket = nearPocket || (dx * dx + dy * dy < zone * zone);
+    }
+
+    float r = b.radius[i];
+    if (!nearPocket) { // В области лузы не отражаем!
+        if ((x - r < p.left && vx < 0) || (x + r > p.right && vx > 0))
+            vx = -vx * C::cushion(p);
+        if ((y - r < p.top && vy < 0) || (y + r > p.bottom && vy > 0))
+            vy = -vy * C::cushion(p);
+    }
+
+    b.x[i] = x;
+    b.y[i] = y;
+    b.vx[i] = vx;
+    b.vy[i] = vy;
+}
+
+template <class C>
+void scalarWith(BallStore& balls, const IntegrateParams& params) {
+    const std::size_t n = balls.size();
+    for (std::size_t i = 0; i < n; ++i)
+        integrateOne<C>(balls, i, params);
+}
+
+template <class C>
+void indexedWith(BallStore& balls, const std::uint32_t* indices, std::size_t count, const IntegrateParams& params) {
+    for (std::size_t k = 0; k < count; ++k)
+        integrateOne<C>(balls, indices[k], params);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+template <class C>
+void sseWith(BallStore& balls, const IntegrateParams& p) {
+    const std::size_t n = balls.size();
+    float* px = balls.x.data();
+    float* py = balls.y.data();
+    float* pvx = balls.vx.data();
+    float* pvy = balls.vy.data();
+    const float* pr = balls.radius.data();
+
+    const __m128 dt = _mm_set1_ps(p.dt);
+    const __m128 decel = _mm_set1_ps(C::decel(p));
+    const __m128 cushion = _mm_set1_ps(C::cushion(p));
+    const __m128 left = _mm_set1_ps(p.left), right = _mm_set1_ps(p.right);
+    const __m128 top = _mm_set1_ps(p.top), bottom = _mm_set1_ps(p.bottom);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 sign = _mm_set1_ps(-0.f);
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 vx = _mm_loadu_ps(pvx + i);
+        __m128 vy = _mm_loadu_ps(pvy + i);
+        __m128 x = _mm_add_ps(_mm_loadu_ps(px + i), _mm_mul_ps(vx, dt));
+        __m128 y = _mm_add_ps(_mm_loadu_ps(py + i), _mm_mul_ps(vy, dt));
+        __m128 r = _mm_loadu_ps(pr + i);
+
+        // Трение: шары медленнее decel останавливаются, остальные тормозят вдоль скорости
+        __m128 speed = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)));
+        __m128 moving = _mm_cmpgt_ps(speed, decel);
+        vx = _mm_and_ps(moving, _mm_sub_ps(vx, _mm_mul_ps(_mm_div_ps(vx, speed), decel)));
+        vy = _mm_and_ps(moving, _mm_sub_ps(vy, _mm_mul_ps(_mm_div_ps(vy, speed), decel)));
+
+        __m128 near = zero;
+        for (std::size_t k = 0; k < p.pocketCount; ++k) {
+            __m128 dx = _mm_sub_ps(x, _mm_set1_ps(p.pockets[k].x));
+            __m128 dy = _mm_sub_ps(y, _mm_set1_ps(p.pockets[k].y));
+            float zone = p.pockets[k].radius * C::pocketMargin(p);
+            __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+            near = _mm_or_ps(near, _mm_cmplt_ps(d2, _mm_set1_ps(zone * zone)));
+        }
+
+        __m128 hitX = _mm_or_ps(
+            _mm_and_ps(_mm_cmplt_ps(_mm_sub_ps(x, r), left), _mm_cmplt_ps(vx, zero)),
+            _mm_and_ps(_mm_cmpgt_ps(_mm_add_ps(x, r), right), _mm_cmpgt_ps(vx, zero)));
+        __m128 hitY = _mm_or_ps(
+            _mm_and_ps(_mm_cmplt_ps(_mm_sub_ps(y, r), top), _mm_cmplt_ps(vy, zero)),
+            _mm_and_ps(_mm_cmpgt_ps(_mm_add_ps(y, r), bottom), _mm_cmpgt_ps(vy, zero)));
+        hitX = _mm_andnot_ps(near, hitX);
+        hitY = _mm_andnot_ps(near, hitY);
+        __m128 rx = _mm_mul_ps(_mm_xor_ps(vx, sign), cushion);
+        __m128 ry = _mm_mul_ps(_mm_xor_ps(vy, sign), cushion);
+        vx = _mm_or_ps(_mm_and_ps(hitX, rx), _mm_andnot_ps(hitX, vx));
+        vy = _mm_or_ps(_mm_and_ps(hitY, ry), _mm_andnot_ps(hitY, vy));
+
+        _mm_storeu_ps(px + i, x);
+        _mm_storeu_ps(py + i, y);
+        _mm_storeu_ps(pvx + i, vx);
+        _mm_storeu_ps(pvy + i, vy);
+    }
+    for (; i < n; ++i)
+        integrateOne<C>(balls, i, p);
+}
+
+template <class C>
+__attribute__((target("avx2")))
+void avx2With(BallStore& balls, const IntegrateParams& p) {
+    const std::size_t n = balls.size();
+    float* px = balls.x.data();
+    float* py = balls.y.data();
+    float* pvx = balls.vx.data();
+    float* pvy = balls.vy.data();
+    const float* pr = balls.radius.data();
+
+    const __m256 dt = _mm256_set1_ps(p.dt);
+    const __m256 decel = _mm256_set1_ps(C::decel(p));
+    const __m256 cushion = _mm256_set1_ps(C::cushion(p));
+    const __m256 left = _mm256_set1_ps(p.left), right = _mm256_set1_ps(p.right);
+    const __m256 top = _mm256_set1_ps(p.top), bottom = _mm256_set1_ps(p.bottom);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 sign = _mm256_set1_ps(-0.f);
+
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 vx = _mm256_loadu_ps(pvx + i);
+        __m256 vy = _mm256_loadu_ps(pvy + i);
+        __m256 x = _mm256_add_ps(_mm256_loadu_ps(px + i), _mm256_mul_ps(vx, dt));
+        __m256 y = _mm256_add_ps(_mm256_loadu_ps(py + i), _mm256_mul_ps(vy, dt));
+        __m256 r = _mm256_loadu_ps(pr + i);
+
+        __m256 speed = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy)));
+        __m256 moving = _mm256_cmp_ps(speed, decel, _CMP_GT_OQ);
+        vx = _mm256_and_ps(moving, _mm256_sub_ps(vx, _mm256_mul_ps(_mm256_div_ps(vx, speed), decel)));
+        vy = _mm256_and_ps(moving, _mm256_sub_ps(vy, _mm256_mul_ps(_mm256_div_ps(vy, speed), decel)));
+
+        __m256 near = zero;
+        for (std::size_t k = 0; k < p.pocketCount; ++k) {
+            __m256 dx = _mm256_sub_ps(x, _mm256_set1_ps(p.pockets[k].x));
+            __m256 dy = _mm256_sub_ps(y, _mm256_set1_ps(p.pockets[k].y));
+            float zone = p.pockets[k].radius * C::pocketMargin(p);
+            __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+            near = _mm256_or_ps(near, _mm256_cmp_ps(d2, _mm256_set1_ps(zone * zone), _CMP_LT_OQ));
+        }
+
+        __m256 hitX = _mm256_or_ps(
+            _mm256_and_ps(_mm256_cmp_ps(_mm256_sub_ps(x, r), left, _CMP_LT_OQ), _mm256_cmp_ps(vx, zero, _CMP_LT_OQ)),
+            _mm256_and_ps(_mm256_cmp_ps(_mm256_add_ps(x, r), right, _CMP_GT_OQ), _mm256_cmp_ps(vx, zero, _CMP_GT_OQ)));
+        __m256 hitY = _mm256_or_ps(
+            _mm256_and_ps(_mm256_cmp_ps(_mm256_sub_ps(y, r), top, _CMP_LT_OQ), _mm256_cmp_ps(vy, zero, _CMP_LT_OQ)),
+            _mm256_and_ps(_mm256_cmp_ps(_mm256_add_ps(y, r), bottom, _CMP_GT_OQ), _mm256_cmp_ps(vy, zero, _CMP_GT_OQ)));
+        hitX = _mm256_andnot_ps(near, hitX);
+        hitY = _mm256_andnot_ps(near, hitY);
+        vx = _mm256_blendv_ps(vx, _mm256_mul_ps(_mm256_xor_ps(vx, sign), cushion), hitX);
+        vy = _mm256_blendv_ps(vy, _mm256_mul_ps(_mm256_xor_ps(vy, sign), cushion), hitY);
+
+        _mm256_storeu_ps(px + i, x);
+        _mm256_storeu_ps(py + i, y);
+        _mm256_storeu_ps(pvx + i, vx);
+        _mm256_storeu_ps(pvy + i, vy);
+    }
+    for (; i < n; ++i)
+        integrateOne<C>(balls, i, p);
+}
+
+#endif
+
+template <class C>
+IntegrateKernelSet kernelSet() {
+#if defined(__x86_64__) || defined(__i386__)
+    return {&scalarWith<C>, &sseWith<C>, &avx2With<C>, &indexedWith<C>};
+#else
+    return {&scalarWith<C>, nullptr, nullptr, &indexedWith<C>};
+#endif
+}
+
+} // namespace
+
+void integrateScalar(BallStore& balls, const IntegrateParams& params) {
+    scalarWith<RuntimeConstants>(balls, params);
+}
+
+void integrateIndexed(BallStore& balls, const std::uint32_t* indices, std::size_t count,
+                      const IntegrateParams& params) {
+    indexedWith<RuntimeConstants>(balls, indices, count, params);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+void integrateSse(BallStore& balls, const IntegrateParams& params) {
+    sseWith<RuntimeConstants>(balls, params);
+}
+
+void integrateAvx2(BallStore& balls, const IntegrateParams& params) {
+    avx2With<RuntimeConstants>(balls, params);
+}
+#endif
+
+IntegrateKernel IntegrateKernelSet::matching(IntegrateKernel kernel) const {
+    const IntegrateKernelSet& generic = genericIntegrateKernels();
+    if (kernel == generic.avx2 && avx2)
+        return avx2;
+    if (kernel == generic.sse && sse)
+        return sse;
+    if (kernel == generic.scalar)
+        return scalar;
+    return kernel;
+}
+
+const IntegrateKernelSet& genericIntegrateKernels() {
+#if defined(__x86_64__) || defined(__i386__)
+    static const IntegrateKernelSet set{&integrateScalar, &integrateSse, &integrateAvx2, &integrateIndexed};
+#else
+    static const IntegrateKernelSet set{&integrateScalar, nullptr, nullptr, &integrateIndexed};
+#endif
+    return set;
+}
+
+template <class Profile>
+const IntegrateKernelSet& integrateKernelsFor() {
+    static const IntegrateKernelSet set = kernelSet<ProfileConstants<Profile>>();
+    return set;
+}
+
+template const IntegrateKernelSet& integrateKernelsFor<PyramidProfile>();
+template const IntegrateKernelSet& integrateKernelsFor<PoolProfile>();
+template const IntegrateKernelSet& integrateKernelsFor<SnookerProfile>();
+
+IntegrateKernel selectIntegrateKernel() {
+#if defined(__x86_64__) || defined(__i386__)
+    static const IntegrateKernel best = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+            return &integrateAvx2;
+        if (__builtin_cpu_supports("sse2"))
+            return &integrateSse;
+        return &integrateScalar;
+    }();
+    return best;
+#else
+    return &integrateScalar;
+#endif
+}
+
+const char* integrateKernelName(IntegrateKernel kernel) {
+#if defined(__x86_64__) || defined(__i386__)
+    if (kernel == &integrateAvx2)
+        return "avx2";
+    if (kernel == &integrateSse)
+        return "sse";
+#endif
+    return kernel == &integrateScalar ? "scalar" : "unknown";
+}
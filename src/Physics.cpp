@@ -1,55 +1,91 @@
 #include "Physics.hpp"
 #include "Pocket.hpp"
-#include <cmath>
-PhysicsEngine::PhysicsEngine(std::vector<Ball>& balls, const Table& table, const std::vector<Pocket>& pockets)
-    : balls_(balls), table_(table), pockets_(pockets) {}
-
-void PhysicsEngine::update(float dt) {
-    for (auto& ball : balls_) {
-        ball.update(dt);
-        ball.reflectIfNeeded(table_.getBounds(), pockets_);
-    }
-    resolveCollisions();
+#include <algorithm>
+
+static TableGeometry makeGeometry(const Table& table, const std::vector<Pocket>& pockets) {
+    sf::FloatRect bounds = table.getBounds();
+    TableGeometry geom{bounds.left, bounds.top, bounds.width, bounds.height, {}};
+    for (const auto& p : pockets)
+        geom.pockets.push_back({p.pos.x, p.pos.y, p.radius});
+    return geom;
 }
 
-void PhysicsEngine::resolveCollisions() {
-    for (size_t i = 0; i < balls_.size(); ++i) {
-        for (size_t j = i + 1; j < balls_.size(); ++j) {
-            resolveBallBall(balls_[i], balls_[j]);
-        }
+PhysicsEngine::PhysicsEngine(const Table& table, const std::vector<Pocket>& pockets, std::string logDir,
+                             const std::string& profile, std::uint16_t spectatorPort)
+    : geometry_(makeGeometry(table, pockets)),
+      profile_(findPhysicsProfile(profile) ? profile : PyramidProfile::kName),
+      thread_(std::make_unique<SimulationThread>(geometry_, std::move(logDir), profile_, spectatorPort)) {}
+
+void PhysicsEngine::update() {
+    // Снимок раньше событий луз: всё, что случилось до него, уже лежит в очереди
+    if (thread_->poll() && thread_->snapshot().appliedSeq >= syncSeq_)
+        adopt(thread_->snapshot().state);
+
+    SimPocketEvent e;
+    while (thread_->popPocket(e))
+        if (e.appliedSeq >= restoreSeq_)
+            pocketEvents_.push_back(e.event);
+
+    // Рисуем на тик позади физики: доля пути от предыдущего шага к последнему
+    const SimSnapshot& s = thread_->snapshot();
+    if (s.appliedSeq < syncSeq_ || s.state.ballCount != view_.size())
+        return;
+    std::int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        SimulationThread::Clock::now().time_since_epoch()).count();
+    float alpha = std::clamp((now - s.tickTimeNs) * 1e-9f / Simulation::kFixedDt, 0.f, 1.f);
+    for (std::size_t i = 0; i < view_.size(); ++i) {
+        view_.x[i] = s.prevX[i] + (state_.x[i] - s.prevX[i]) * alpha;
+        view_.y[i] = s.prevY[i] + (state_.y[i] - s.prevY[i]) * alpha;
     }
 }
 
-void PhysicsEngine::resolveBallBall(Ball& a, Ball& b) {
-    sf::Vector2f posA = a.getPosition();
-    sf::Vector2f posB = b.getPosition();
-    sf::Vector2f delta = posB - posA;
-    float dist = std::hypot(delta.x, delta.y);
-    float r = a.getRadius() + b.getRadius();
-
-    if (dist > 0.f && dist < r) {
-        float overlap = r - dist + 0.1f;
-        sf::Vector2f correction = delta / dist * (overlap / 2.f);
-        a.move(-correction);
-        b.move(correction);
-
-        sf::Vector2f norm = delta / dist;
-        sf::Vector2f velA = a.getVelocity();
-        sf::Vector2f velB = b.getVelocity();
-
-        float vA = velA.x * norm.x + velA.y * norm.y;
-        float vB = velB.x * norm.x + velB.y * norm.y;
-
-        if (vA - vB > 0) {
-            float m1 = 1.f, m2 = 1.f;
-            float p = (2.f * (vA - vB)) / (m1 + m2);
-            float restitution = 0.95f;
-            velA -= p * m2 * norm; velA *= restitution;
-            velB += p * m1 * norm; velB *= restitution;
-
-            a.setVelocity(velA);
-            b.setVelocity(velB);
-        }
-    }
+void PhysicsEngine::adopt(const TableState& state) {
+    state_ = state;
+    state_.restore(view_);
+}
+
+Simulation PhysicsEngine::simulation() const {
+    Simulation sim(geometry_);
+    sim.setProfile(profile_);
+    state_.restore(sim.balls());
+    return sim;
 }
 
+bool PhysicsEngine::isMoving() const {
+    const SimSnapshot& s = thread_->snapshot();
+    return s.moving || s.appliedSeq < sentSeq_;
+}
+
+void PhysicsEngine::shoot(std::size_t i, sf::Vector2f dir, float power) {
+    SimCommand c;
+    c.type = SimCommand::Shot;
+    c.ball = view_.id[i];
+    c.x = dir.x;
+    c.y = dir.y;
+    c.power = power;
+    sentSeq_ = thread_->send(c);
+}
+
+void PhysicsEngine::respot(int number, sf::Vector2f pos, float radius) {
+    SimCommand c;
+    c.type = SimCommand::Respot;
+    c.number = number;
+    c.x = pos.x;
+    c.y = pos.y;
+    c.radius = radius;
+    sentSeq_ = thread_->send(c);
+}
+
+void PhysicsEngine::restore(const TableState& state) {
+    SimCommand c;
+    c.type = SimCommand::Restore;
+    c.state = state;
+    sentSeq_ = syncSeq_ = restoreSeq_ = thread_->send(c);
+    // Игра видит новый стол сразу; старые снимки до применения команды пропускаются
+    adopt(state);
+    pocketEvents_.clear();
+}
+
+sf::Vector2f PhysicsEngine::getPosition(std::size_t i) const {
+    return {view_.x[i], view_.y[i]};
+}
@@ -0,0 +1,288 @@
+#include "ShotLog.hpp"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace {
+
+constexpr char kMagic[4] = {'S', 'H', 'O', 'T'};
+
+// Поля пишутся по одному, как лежат в памяти (little-endian на всех наших платформах)
+template <typename T>
+void put(std::vector<char>& out, const T& value) {
+    const char* p = reinterpret_cast<const char*>(&value);
+    out.insert(out.end(), p, p + sizeof(T));
+}
+
+struct Reader {
+    const std::vector<char>& data;
+    std::size_t pos = 0;
+
+    template <typename T>
+    bool get(T& value) {
+        if (data.size() - pos < sizeof(T))
+            return false;
+        std::memcpy(&value, data.data() + pos, sizeof(T));
+        pos += sizeof(T);
+        return true;
+    }
+};
+
+} // namespace
+
+void ShotLog::begin(const Simulation& sim) {
+    table_ = sim.table();
+    profile_ = sim.profile();
+    collisionMode_ = sim.collisionMode();
+    initial_.clear();
+    for (std::size_t i = 0; i < sim.balls().size(); ++i)
+        initial_.push_back(sim.balls().get(i));
+    records_.clear();
+    startTick_ = sim.tick();
+    nextChecksum_ = 0;
+    checksum(sim);
+}
+
+void ShotLog::shot(const Simulation& sim, int ball, float dirX, float dirY, float power) {
+    LogRecord r{LogEvent::Shot, ticks(sim)};
+    r.ball = ball;
+    r.x = dirX;
+    r.y = dirY;
+    r.power = power;
+    records_.push_back(r);
+}
+
+void ShotLog::place(const Simulation& sim, int number) {
+    int i = sim.balls().find(number);
+    if (i < 0)
+        return;
+    LogRecord r{LogEvent::Place, ticks(sim)};
+    r.ball = number;
+    r.x = sim.balls().x[i];
+    r.y = sim.balls().y[i];
+    r.vx = sim.balls().vx[i];
+    r.vy = sim.balls().vy[i];
+    r.radius = sim.balls().radius[i];
+    records_.push_back(r);
+}
+
+void ShotLog::frame(const Simulation& sim) {
+    if (ticks(sim) >= nextChecksum_)
+        checksum(sim);
+}
+
+void ShotLog::finish(const Simulation& sim) {
+    if (records_.empty() || records_.back().type != LogEvent::Checksum || records_.back().tick != ticks(sim))
+        checksum(sim);
+}
+
+void ShotLog::checksum(const Simulation& sim) {
+    LogRecord r{LogEvent::Checksum, ticks(sim)};
+    r.checksum = sim.stateHash();
+    records_.push_back(r);
+    nextChecksum_ = r.tick + kChecksumInterval;
+}
+
+std::size_t ShotLog::shots() const {
+    std::size_t n = 0;
+    for (const auto& r : records_)
+        n += r.type == LogEvent::Shot;
+    return n;
+}
+
+bool ShotLog::save(const std::string& path) const {
+    std::vector<char> out;
+    out.insert(out.end(), kMagic, kMagic + sizeof(kMagic));
+    put(out, kVersion);
+    put(out, static_cast<std::uint32_t>(profile_.size()));
+    out.insert(out.end(), profile_.begin(), profile_.end());
+    put(out, static_cast<std::uint8_t>(collisionMode_));
+    put(out, table_.left);
+    put(out, table_.top);
+    put(out, table_.width);
+    put(out, table_.height);
+    put(out, static_cast<std::uint32_t>(table_.pockets.size()));
+    for (const auto& p : table_.pockets) {
+        put(out, p.x);
+        put(out, p.y);
+        put(out, p.radius);
+    }
+    put(out, static_cast<std::uint32_t>(initial_.size()));
+    for (const auto& b : initial_) {
+        put(out, b.x);
+        put(out, b.y);
+        put(out, b.vx);
+        put(out, b.vy);
+        put(out, b.radius);
+        put(out, static_cast<std::int32_t>(b.number));
+    }
+
+    // Запись — тип, тик и только те поля, что нужны этому типу
+    put(out, static_cast<std::uint32_t>(records_.size()));
+    for (const auto& r : records_) {
+        put(out, r.type);
+        put(out, r.tick);
+        switch (r.type) {
+        case LogEvent::Shot:
+            put(out, r.ball);
+            put(out, r.x);
+            put(out, r.y);
+            put(out, r.power);
+            break;
+        case LogEvent::Place:
+            put(out, r.ball);
+            put(out, r.x);
+            put(out, r.y);
+            put(out, r.vx);
+            put(out, r.vy);
+            put(out, r.radius);
+            break;
+        case LogEvent::Checksum:
+            put(out, r.checksum);
+            break;
+        }
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(out.data(), static_cast<std::streamsize>(out.size()));
+    return static_cast<bool>(file);
+}
+
+bool ShotLog::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+    std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    Reader in{data};
+
+    char magic[4];
+    std::uint32_t version = 0;
+    if (!in.get(magic) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 || !in.get(version) ||
+        version < 2 || version > kVersion)
+        return false;
+
+    std::string profile = PyramidProfile::kName;
+    if (version >= 3) {
+        std::uint32_t length = 0;
+        if (!in.get(length) || data.size() - in.pos < length)
+            return false;
+        profile.assign(data.data() + in.pos, length);
+        in.pos += length;
+    }
+    CollisionMode mode = CollisionMode::Grid;
+    if (version >= 4) {
+        std::uint8_t m = 0;
+        if (!in.get(m) || m > static_cast<std::uint8_t>(CollisionMode::Contacts))
+            return false;
+        mode = static_cast<CollisionMode>(m);
+    }
+
+    TableGeometry table{};
+    std::uint32_t count = 0;
+    if (!in.get(table.left) || !in.get(table.top) || !in.get(table.width) || !in.get(table.height) || !in.get(count))
+        return false;
+    for (std::uint32_t k = 0; k < count; ++k) {
+        PocketState p{};
+        if (!in.get(p.x) || !in.get(p.y) || !in.get(p.radius))
+            return false;
+        table.pockets.push_back(p);
+    }
+
+    std::vector<BallState> initial;
+    if (!in.get(count))
+        return false;
+    for (std::uint32_t k = 0; k < count; ++k) {
+        BallState b{};
+        std::int32_t number = 0;
+        if (!in.get(b.x) || !in.get(b.y) || !in.get(b.vx) || !in.get(b.vy) || !in.get(b.radius) || !in.get(number))
+            return false;
+        b.number = number;
+        initial.push_back(b);
+    }
+
+    std::vector<LogRecord> records;
+    if (!in.get(count))
+        return false;
+    for (std::uint32_t k = 0; k < count; ++k) {
+        LogRecord r{};
+        if (!in.get(r.type) || !in.get(r.tick))
+            return false;
+        bool ok = true;
+        switch (r.type) {
+        case LogEvent::Shot:
+            ok = in.get(r.ball) && in.get(r.x) && in.get(r.y) && in.get(r.power);
+            break;
+        case LogEvent::Place:
+            ok = in.get(r.ball) && in.get(r.x) && in.get(r.y) && in.get(r.vx) && in.get(r.vy) && in.get(r.radius);
+            break;
+        case LogEvent::Checksum:
+            ok = in.get(r.checksum);
+            break;
+        default:
+            ok = false;
+        }
+        if (!ok)
+            return false;
+        records.push_back(r);
+    }
+
+    table_ = std::move(table);
+    profile_ = std::move(profile);
+    collisionMode_ = mode;
+    initial_ = std::move(initial);
+    records_ = std::move(records);
+    startTick_ = 0;
+    nextChecksum_ = records_.empty() ? 0 : records_.back().tick + kChecksumInterval;
+    return true;
+}
+
+ReplayResult ShotLog::replay(const std::function<void(const Simulation&)>& onTick) const {
+    ReplayResult result;
+    Simulation sim(table_, initial_);
+    BallStore& balls = sim.balls();
+    auto fail = [&](std::uint64_t tick) {
+        result.ok = false;
+        result.failedTick = tick;
+        result.ticks = sim.tick();
+        return result;
+    };
+    // Партия с параметрами не из реестра (setParams) не воспроизводится
+    if (!sim.setProfile(profile_))
+        return fail(0);
+    sim.setCollisionMode(collisionMode_);
+    if (onTick)
+        onTick(sim);
+
+    for (const auto& r : records_) {
+        if (r.tick < sim.tick())
+            return fail(r.tick);
+        while (sim.tick() < r.tick) {
+            sim.step();
+            if (onTick)
+                onTick(sim);
+        }
+
+        switch (r.type) {
+        case LogEvent::Shot:
+            if (r.ball < 0 || static_cast<std::size_t>(r.ball) >= balls.size())
+                return fail(r.tick);
+            balls.setVelocity(r.ball, r.x * r.power, r.y * r.power);
+            break;
+        case LogEvent::Place: {
+            int i = balls.find(r.ball);
+            if (i < 0)
+                i = balls.indexOf(balls.push({r.x, r.y, r.vx, r.vy, r.radius, r.ball}));
+            balls.setPosition(i, r.x, r.y);
+            balls.setVelocity(i, r.vx, r.vy);
+            break;
+        }
+        case LogEvent::Checksum:
+            if (sim.stateHash() != r.checksum)
+                return fail(r.tick);
+            ++result.checksums;
+            break;
+        }
+    }
+    result.ticks = sim.tick();
+    return result;
+}
@@ -0,0 +1,104 @@
+#include "ShotSolver.hpp"
+#include "EventSimulation.hpp"
+#include "TableState.hpp"
+#include <algorithm>
+#include <cmath>
+
+ShotSolver::ShotSolver(WorkStealingPool& pool) : pool_(pool) {}
+
+ShotOutcome ShotSolver::evaluate(Simulation& scratch, const Shot& shot, bool exact) {
+    BallStore& balls = scratch.balls();
+    balls.setVelocity(shot.ball, std::cos(shot.angle) * shot.power, std::sin(shot.angle) * shot.power);
+
+    std::vector<int> pocketed;
+    if (exact) {
+        EventSimulation events(scratch);
+        events.simulateUntilRest(&pocketed);
+    } else {
+        scratch.simulateUntilRest(&pocketed);
+    }
+
+    ShotOutcome out{shot, 0, false, 0.f};
+    for (int number : pocketed) {
+        if (number == 0)
+            out.scratch = true;
+        else
+            ++out.pocketed;
+    }
+    // Очки засчитываются и при фоле, но ход теряется — такой удар хуже чистого
+    out.score = static_cast<float>(out.pocketed) - (out.scratch ? 0.5f : 0.f);
+    return out;
+}
+
+// Углы в порядке от грубой сетки к мелкой: 0, N/2, N/4, 3N/4, ...
+static std::vector<int> coarseToFine(int steps) {
+    std::vector<int> order;
+    std::vector<char> used(steps, 0);
+    int stride = 1;
+    while (stride * 2 <= steps)
+        stride *= 2;
+    for (; stride >= 1; stride /= 2)
+        for (int a = 0; a < steps; a += stride)
+            if (!used[a]) {
+                used[a] = 1;
+                order.push_back(a);
+            }
+    return order;
+}
+
+std::vector<ShotOutcome> ShotSolver::search(const Simulation& table, const ShotSearchParams& params) {
+    using Clock = std::chrono::steady_clock;
+    const auto deadline = Clock::now() + params.budget;
+    const bool limited = params.budget.count() > 0;
+
+    std::vector<int> balls = params.balls;
+    if (balls.empty())
+        for (std::size_t i = 0; i < table.balls().size(); ++i)
+            balls.push_back(static_cast<int>(i));
+
+    std::vector<Shot> shots;
+    const float step = 2.f * 3.1415926f / params.angleSteps;
+    for (int a : coarseToFine(params.angleSteps))
+        for (float power : params.powers)
+            for (int ball : balls)
+                shots.push_back({ball, a * step, power});
+
+    // Каждый кандидат стартует со снимка: memcpy шаров вместо копии всей Simulation
+    TableState base;
+    const bool flat = base.capture(table.balls());
+
+    scratch_.assign(pool_.size(), table);
+    std::vector<ShotOutcome> outcomes(shots.size());
+    std::vector<char> done(shots.size(), 0);
+
+    pool_.parallelFor(shots.size(), [&](std::size_t i, unsigned worker) {
+        if (limited && Clock::now() >= deadline)
+            return;
+        Simulation& scratch = scratch_[worker];
+        if (flat) {
+            base.restore(scratch.balls());
+            scratch.resetContacts();
+        } else {
+            scratch = table;
+        }
+        outcomes[i] = evaluate(scratch, shots[i], params.exact);
+        done[i] = 1;
+    });
+
+    std::vector<ShotOutcome> ranked;
+    for (std::size_t i = 0; i < shots.size(); ++i)
+        if (done[i])
+            ranked.push_back(outcomes[i]);
+    lastEvaluated_ = ranked.size();
+
+    // При равных очках — удар послабее: он надёжнее и меньше разбивает позицию
+    auto better = [](const ShotOutcome& a, const ShotOutcome& b) {
+        if (a.score != b.score)
+            return a.score > b.score;
+        return a.shot.power < b.shot.power;
+    };
+    std::size_t keep = std::min(params.maxResults, ranked.size());
+    std::partial_sort(ranked.begin(), ranked.begin() + keep, ranked.end(), better);
+    ranked.resize(keep);
+    return ranked;
+}
@@ -0,0 +1,262 @@
+#include "ShotTable.hpp"
+#include "EventSimulation.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace {
+
+constexpr char kMagic[4] = {'S', 'T', 'B', 'L'};
+
+// Всё, от чего зависит исход удара; сравнивается побайтно
+struct PhysicsKey {
+    float mu, gravity, restitution, cushion, pocketMargin, captureDepth;
+    float width, height, ballRadius, pocketRadius;
+};
+
+struct Header {
+    char magic[4];
+    std::uint32_t version;
+    PhysicsKey key;
+    std::uint32_t trials;
+    float aimJitter;
+    ShotTable::Axis axes[5];
+    std::uint32_t cellCount;
+};
+
+PhysicsKey physicsKey(const TableLayout& layout, const PhysicsParams& p) {
+    return {p.mu, p.gravity, p.restitution, p.cushion, p.pocketMargin, p.captureDepth,
+            layout.width, layout.height, layout.ballRadius, layout.pocketRadius};
+}
+
+struct Vec {
+    float x, y;
+};
+
+Vec rotate(Vec v, float a) {
+    float c = std::cos(a), s = std::sin(a);
+    return {v.x * c - v.y * s, v.x * s + v.y * c};
+}
+
+float signedAngle(Vec from, Vec to) {
+    return std::atan2(from.x * to.y - from.y * to.x, from.x * to.x + from.y * to.y);
+}
+
+float axisValue(const ShotTable::Axis& a, std::uint32_t i) {
+    return a.count > 1 ? a.min + (a.max - a.min) * i / (a.count - 1) : a.min;
+}
+
+// Ячейка сетки на столе layout: луза — верхняя левая или верхняя средняя.
+// Биток и прицельный (номер 1) ставятся в balls, направление удара — в aim.
+// false — шар не помещается на стол или стоит в зоне лузы
+bool placeCell(const TableLayout& layout, const PhysicsParams& params, const ShotQuery& q, BallStore& balls, Vec& aim) {
+    const float r = layout.ballRadius;
+    Vec pocket = q.sidePocket ? Vec{layout.x + layout.width / 2, layout.y} : Vec{layout.x, layout.y};
+    Vec axis = q.sidePocket ? Vec{0.f, 1.f} : Vec{0.70710678f, 0.70710678f};
+
+    Vec out = rotate(axis, q.approach);
+    Vec object{pocket.x + out.x * q.pocketDistance, pocket.y + out.y * q.pocketDistance};
+    Vec ghost{object.x + out.x * 2 * r, object.y + out.y * 2 * r};
+    aim = rotate({-out.x, -out.y}, q.cut);
+    Vec cue{ghost.x - aim.x * q.cueDistance, ghost.y - aim.y * q.cueDistance};
+
+    auto onCloth = [&](Vec p) {
+        if (p.x < layout.x + r || p.x > layout.x + layout.width - r ||
+            p.y < layout.y + r || p.y > layout.y + layout.height - r)
+            return false;
+        for (const PocketState& k : layout.geometry().pockets)
+            if (std::hypot(p.x - k.x, p.y - k.y) < k.radius * params.pocketMargin + r)
+                return false;
+        return true;
+    };
+    if (!onCloth(object) || !onCloth(cue) || std::hypot(cue.x - object.x, cue.y - object.y) < 2 * r - 1e-3f)
+        return false;
+
+    balls.clear();
+    balls.push({cue.x, cue.y, 0.f, 0.f, r, 0});
+    balls.push({object.x, object.y, 0.f, 0.f, r, 1});
+    return true;
+}
+
+} // namespace
+
+bool ShotTable::build(const TableLayout& layout, const Grid& grid, WorkStealingPool& pool, const std::string& path,
+                      const PhysicsParams& params) {
+    Header h{};
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version = kVersion;
+    h.key = physicsKey(layout, params);
+    h.trials = grid.trials;
+    h.aimJitter = grid.aimJitter;
+    const Axis axes[kAxes] = {grid.cueDistance, grid.cut, grid.pocketDistance, grid.approach, grid.power};
+    std::size_t rows = 2;
+    for (int a = 0; a < kAxes; ++a) {
+        h.axes[a] = axes[a];
+        if (a + 1 < kAxes)
+            rows *= axes[a].count;
+    }
+    const std::uint32_t powers = grid.power.count;
+    h.cellCount = static_cast<std::uint32_t>(rows * powers);
+
+    // Строка — все силы одной расстановки: шары ставятся один раз
+    std::vector<std::uint8_t> cells(h.cellCount, kUnreachable);
+    const TableGeometry table = layout.geometry();
+    pool.parallelFor(rows, [&](std::size_t row, unsigned) {
+        std::size_t rest = row;
+        std::uint32_t idx[kAxes - 1];
+        for (int a = kAxes - 2; a >= 0; --a) {
+            idx[a] = static_cast<std::uint32_t>(rest % axes[a].count);
+            rest /= axes[a].count;
+        }
+        ShotQuery q;
+        q.sidePocket = rest != 0;
+        q.cueDistance = axisValue(grid.cueDistance, idx[0]);
+        q.cut = axisValue(grid.cut, idx[1]);
+        q.pocketDistance = axisValue(grid.pocketDistance, idx[2]);
+        q.approach = axisValue(grid.approach, idx[3]);
+
+        BallStore balls;
+        Vec aim;
+        if (!placeCell(layout, params, q, balls, aim))
+            return;
+        for (std::uint32_t p = 0; p < powers; ++p) {
+            float power = axisValue(grid.power, p);
+            std::uint32_t hits = 0;
+            for (std::uint32_t t = 0; t < grid.trials; ++t) {
+                // Разброс прицела равномерно по [-aimJitter, aimJitter]
+                float err = grid.trials > 1 ? grid.aimJitter * (2.f * t / (grid.trials - 1) - 1.f) : 0.f;
+                Vec dir = rotate(aim, err);
+                balls.setVelocity(0, dir.x * power, dir.y * power);
+                EventSimulation events(table, balls, params);
+                events.simulateUntilRest();
+                const auto& pocketed = events.pocketed();
+                hits += std::find(pocketed.begin(), pocketed.end(), 1) != pocketed.end();
+            }
+            cells[row * powers + p] = static_cast<std::uint8_t>((254 * hits + grid.trials / 2) / grid.trials);
+        }
+    });
+
+    std::error_code ec;
+    std::filesystem::path dir = std::filesystem::path(path).parent_path();
+    if (!dir.empty())
+        std::filesystem::create_directories(dir, ec);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    file.write(reinterpret_cast<const char*>(cells.data()), static_cast<std::streamsize>(cells.size()));
+    return static_cast<bool>(file);
+}
+
+bool ShotTable::open(const std::string& path, const TableLayout& layout, const PhysicsParams& params) {
+    close();
+    if (!file_.open(path)) {
+        error_ = "cannot map " + path;
+        return false;
+    }
+    Header h;
+    if (file_.size() < sizeof(h) || std::memcmp(file_.data(), kMagic, sizeof(kMagic)) != 0) {
+        error_ = path + " is not a shot table";
+        close();
+        return false;
+    }
+    std::memcpy(&h, file_.data(), sizeof(h));
+    PhysicsKey key = physicsKey(layout, params);
+    if (h.version != kVersion || std::memcmp(&h.key, &key, sizeof(key)) != 0) {
+        error_ = path + " was built for another format, physics or table; rebuild it";
+        close();
+        return false;
+    }
+
+    std::size_t count = 1;
+    for (int a = kAxes - 1; a >= 0; --a) {
+        axes_[a] = h.axes[a];
+        stride_[a] = count;
+        count *= std::max<std::uint32_t>(axes_[a].count, 1);
+    }
+    kindStride_ = count;
+    if (h.cellCount != 2 * count || file_.size() != sizeof(h) + h.cellCount) {
+        error_ = path + " is truncated";
+        close();
+        return false;
+    }
+    cells_ = file_.data() + sizeof(h);
+    error_.clear();
+    return true;
+}
+
+void ShotTable::close() {
+    file_.close();
+    cells_ = nullptr;
+}
+
+float ShotTable::probability(const ShotQuery& q) const {
+    if (!cells_)
+        return 0.f;
+    const float v[kAxes] = {q.cueDistance, q.cut, q.pocketDistance, q.approach, q.power};
+    // Углы ячейки набираются по осям: на каждой оси список удваивается,
+    // 62 умножения на все 32 угла вместо 5 на каждый
+    std::size_t at[1u << kAxes] = {q.sidePocket ? kindStride_ : 0};
+    float w[1u << kAxes] = {1.f};
+    std::size_t corners = 1;
+    for (int a = 0; a < kAxes; ++a) {
+        const Axis& axis = axes_[a];
+        if (axis.count < 2)
+            continue;
+        float t = (v[a] - axis.min) / (axis.max - axis.min) * (axis.count - 1);
+        t = std::clamp(t, 0.f, static_cast<float>(axis.count - 1));
+        std::uint32_t i = std::min(static_cast<std::uint32_t>(t), axis.count - 2);
+        float f = t - i;
+        for (std::size_t c = 0; c < corners; ++c) {
+            at[c] += i * stride_[a];
+            at[c + corners] = at[c] + stride_[a];
+            w[c + corners] = w[c] * f;
+            w[c] *= 1.f - f;
+        }
+        corners *= 2;
+    }
+
+    // Недостижимые углы выпадают из веса
+    float sum = 0.f, weight = 0.f;
+    for (std::size_t c = 0; c < corners; ++c) {
+        std::uint8_t cell = cells_[at[c]];
+        if (cell != kUnreachable) {
+            sum += w[c] * cell;
+            weight += w[c];
+        }
+    }
+    return weight > 0.f ? sum / (weight * 254.f) : 0.f;
+}
+
+ShotQuery ShotTable::describe(const TableGeometry& table, const BallStore& balls,
+                              int cue, int object, int pocket, float power) {
+    const PocketState& p = table.pockets[pocket];
+    float cx = table.left + table.width / 2, cy = table.top + table.height / 2;
+    float sx = cx > p.x ? 1.f : -1.f, sy = cy > p.y ? 1.f : -1.f;
+
+    // Отражение к канонической лузе меняет знак углов
+    ShotQuery q;
+    q.sidePocket = p.x > table.left + 1.f && p.x < table.left + table.width - 1.f;
+    Vec axis = q.sidePocket ? Vec{0.f, sy} : Vec{sx * 0.70710678f, sy * 0.70710678f};
+    float mirror = q.sidePocket ? sy : sx * sy;
+
+    Vec out{balls.x[object] - p.x, balls.y[object] - p.y};
+    q.pocketDistance = std::hypot(out.x, out.y);
+    if (q.pocketDistance > 0.f)
+        out = {out.x / q.pocketDistance, out.y / q.pocketDistance};
+    float reach = balls.radius[object] + balls.radius[cue];
+    Vec ghost{balls.x[object] + out.x * reach, balls.y[object] + out.y * reach};
+    Vec aim{ghost.x - balls.x[cue], ghost.y - balls.y[cue]};
+    q.cueDistance = std::hypot(aim.x, aim.y);
+
+    q.approach = mirror * signedAngle(axis, out);
+    q.cut = mirror * signedAngle({-out.x, -out.y}, aim);
+    q.power = power;
+    return q;
+}
+
+float ShotTable::probability(const TableGeometry& table, const BallStore& balls,
+                             int cue, int object, int pocket, float power) const {
+    return probability(describe(table, balls, cue, object, pocket, power));
+}
@@ -0,0 +1,275 @@
+#include "Simulation.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Константы профиля: компилятор подставляет их в шаг как литералы
+template <class Profile>
+struct FixedParams {
+    static constexpr float mu()           { return Profile::kParams.mu; }
+    static constexpr float gravity()      { return Profile::kParams.gravity; }
+    static constexpr float restitution()  { return Profile::kParams.restitution; }
+    static constexpr float cushion()      { return Profile::kParams.cushion; }
+    static constexpr float pocketMargin() { return Profile::kParams.pocketMargin; }
+    static constexpr float captureDepth() { return Profile::kParams.captureDepth; }
+};
+
+// Параметры из Simulation::params_ — общий шаг для setParams
+struct RuntimeParams {
+    const PhysicsParams& p;
+    float mu() const           { return p.mu; }
+    float gravity() const      { return p.gravity; }
+    float restitution() const  { return p.restitution; }
+    float cushion() const      { return p.cushion; }
+    float pocketMargin() const { return p.pocketMargin; }
+    float captureDepth() const { return p.captureDepth; }
+};
+
+template <class Profile>
+PhysicsProfileInfo profileEntry(void (*step)(Simulation&)) {
+    return {Profile::kName, Profile::kParams, step, &integrateKernelsFor<Profile>()};
+}
+
+} // namespace
+
+const std::vector<PhysicsProfileInfo>& physicsProfiles() {
+    static const std::vector<PhysicsProfileInfo> profiles = {
+        profileEntry<PyramidProfile>(&Simulation::stepWith<FixedParams<PyramidProfile>>),
+        profileEntry<PoolProfile>(&Simulation::stepWith<FixedParams<PoolProfile>>),
+        profileEntry<SnookerProfile>(&Simulation::stepWith<FixedParams<SnookerProfile>>),
+    };
+    return profiles;
+}
+
+const PhysicsProfileInfo* findPhysicsProfile(const std::string& name) {
+    for (const auto& p : physicsProfiles())
+        if (name == p.name)
+            return &p;
+    return nullptr;
+}
+
+Simulation::Simulation(const TableGeometry& table, const std::vector<BallState>& balls)
+    : table_(table), step_(&Simulation::stepWith<FixedParams<PyramidProfile>>)
+{
+    balls_.reserve(balls.size());
+    for (const auto& b : balls)
+        balls_.push(b);
+}
+
+bool Simulation::setProfile(const std::string& name) {
+    const PhysicsProfileInfo* p = findPhysicsProfile(name);
+    if (!p)
+        return false;
+    params_ = p->params;
+    profile_ = p->name;
+    step_ = p->step;
+    kernels_ = p->kernels;
+    return true;
+}
+
+void Simulation::setParams(const PhysicsParams& params) {
+    params_ = params;
+    profile_.clear();
+    step_ = [](Simulation& sim) { sim.run(RuntimeParams{sim.params_}); };
+    kernels_ = &genericIntegrateKernels();
+}
+
+template <class P>
+void Simulation::stepWith(Simulation& sim) {
+    sim.run(P{});
+}
+
+template <class P>
+void Simulation::run(const P& p) {
+    ++tick_;
+    lastSubsteps_ = 0;
+    if (balls_.awakeCount() == 0)
+        return;
+
+    // Подшаг — полный шаг короче: сон и пробуждение между подшагами, чтобы
+    // задетый шар двигался уже в следующем
+    const int n = substepsNeeded();
+    const float dt = kFixedDt / n;
+    for (int s = 0; s < n && balls_.awakeCount() > 0; ++s) {
+        if (s > 0) {
+            awake_.clear();
+            for (std::size_t i = 0; i < balls_.size(); ++i)
+                if (balls_.isAwake(i))
+                    awake_.push_back(static_cast<std::uint32_t>(i));
+        }
+        integrate(p, dt);
+        resolveCollisions(p);
+        capturePockets(p);
+        settle();
+        ++lastSubsteps_;
+    }
+    substeps_ += lastSubsteps_;
+}
+
+int Simulation::substepsNeeded() {
+    // Заодно собирает бодрствующих для первого подшага
+    awake_.clear();
+    float maxSpeed2 = 0.f;
+    float minRadius = balls_.radius[0];
+    for (std::size_t i = 0; i < balls_.size(); ++i) {
+        minRadius = std::min(minRadius, balls_.radius[i]);
+        if (balls_.isAwake(i)) {
+            awake_.push_back(static_cast<std::uint32_t>(i));
+            maxSpeed2 = std::max(maxSpeed2, balls_.vx[i] * balls_.vx[i] + balls_.vy[i] * balls_.vy[i]);
+        }
+    }
+    float travel = std::sqrt(maxSpeed2) * kFixedDt;
+    float limit = kMaxTravel * minRadius;
+    if (!(travel > limit))
+        return 1;
+    return static_cast<int>(std::min(std::ceil(travel / limit), static_cast<float>(kMaxSubsteps)));
+}
+
+int Simulation::advance(float dt) {
+    accumulator_ += std::min(dt, kMaxFrameDt);
+    int steps = 0;
+    while (accumulator_ >= kFixedDt) {
+        step();
+        accumulator_ -= kFixedDt;
+        ++steps;
+    }
+    return steps;
+}
+
+int Simulation::simulateUntilRest(std::vector<int>* pocketed, int maxSteps) {
+    int steps = 0;
+    while (steps < maxSteps && !isAtRest()) {
+        step();
+        ++steps;
+    }
+    if (pocketed)
+        for (const auto& e : pocketEvents_)
+            pocketed->push_back(e.number);
+    pocketEvents_.clear();
+    return steps;
+}
+
+template <class P>
+void Simulation::capturePockets(const P& pp) {
+    // С конца: swap-remove ставит на место i уже проверенный шар
+    for (std::size_t i = balls_.size(); i-- > 0;) {
+        // Спящий шар с прошлого шага не сдвинулся; задетый ударом — мог
+        if (!(balls_.flags[i] & (kBallAwake | kBallTouched)))
+            continue;
+        float x = balls_.x[i], y = balls_.y[i];
+        for (std::size_t k = 0; k < table_.pockets.size(); ++k) {
+            const auto& p = table_.pockets[k];
+            float depth = p.radius - balls_.radius[i] * pp.captureDepth();
+            float dx = x - p.x, dy = y - p.y;
+            if (depth > 0.f && dx * dx + dy * dy < depth * depth) {
+                pocketEvents_.push_back({tick_, balls_.id[i], balls_.number[i], static_cast<int>(k), x, y});
+                balls_.erase(i);
+                break;
+            }
+        }
+    }
+}
+
+void Simulation::settle() {
+    // Засыпает шар, который трение остановило совсем: скорость ровно 0 —
+    // неподвижная точка интегрирования, так что сон не меняет траекторий.
+    // Задетый шар не спит ещё шаг: сдвиг мог создать новое перекрытие
+    for (std::size_t i = 0; i < balls_.size(); ++i) {
+        std::uint8_t& f = balls_.flags[i];
+        if (f & kBallTouched) {
+            f &= static_cast<std::uint8_t>(~kBallTouched);
+            balls_.wake(i);
+        } else if ((f & kBallAwake) && balls_.vx[i] == 0.f && balls_.vy[i] == 0.f) {
+            balls_.sleep(i);
+        }
+    }
+}
+
+std::uint64_t Simulation::stateHash() const {
+    // FNV-1a по сырым байтам массивов: совпадение означает побитово тот же стол
+    std::uint64_t h = 1469598103934665603ull;
+    auto mix = [&h](const void* data, std::size_t size) {
+        const auto* p = static_cast<const std::uint8_t*>(data);
+        for (std::size_t i = 0; i < size; ++i) {
+            h ^= p[i];
+            h *= 1099511628211ull;
+        }
+    };
+    std::size_t n = balls_.size();
+    mix(&n, sizeof(n));
+    mix(balls_.x.data(), n * sizeof(float));
+    mix(balls_.y.data(), n * sizeof(float));
+    mix(balls_.vx.data(), n * sizeof(float));
+    mix(balls_.vy.data(), n * sizeof(float));
+    mix(balls_.number.data(), n * sizeof(int));
+    return h;
+}
+
+template <class P>
+void Simulation::integrate(const P& p, float dt) {
+    // Ядра профиля берут из params только dt и стол, общие (setParams) — всё
+    IntegrateParams params{
+        dt, p.mu() * p.gravity() * dt, p.cushion(),
+        table_.left, table_.top, table_.left + table_.width, table_.top + table_.height,
+        table_.pockets.data(), table_.pockets.size(), p.pocketMargin()
+    };
+    if (awake_.size() * kSparseIntegrate < balls_.size())
+        kernels_->indexed(balls_, awake_.data(), awake_.size(), params);
+    else
+        kernels_->matching(kernel_)(balls_, params);
+}
+
+template <class P>
+void Simulation::resolveCollisions(const P& p) {
+    if (collisionMode_ == CollisionMode::Pairwise) {
+        for (std::size_t i = 0; i < balls_.size(); ++i)
+            for (std::size_t j = i + 1; j < balls_.size(); ++j)
+                resolveBallBall(p, i, j);
+        return;
+    }
+
+    grid_.build(balls_, table_.left, table_.top, table_.width, table_.height);
+    if (collisionMode_ == CollisionMode::Contacts) {
+        contacts_.solve(balls_, grid_.pairs(), p.restitution());
+        return;
+    }
+    for (const auto& [a, b] : grid_.pairs())
+        resolveBallBall(p, a, b);
+}
+
+template <class P>
+void Simulation::resolveBallBall(const P& pp, std::size_t a, std::size_t b) {
+    float dx = balls_.x[b] - balls_.x[a];
+    float dy = balls_.y[b] - balls_.y[a];
+    float dist = std::hypot(dx, dy);
+    float r = balls_.radius[a] + balls_.radius[b];
+    if (!(dist > 0.f && dist < r))
+        return;
+
+    float nx = dx / dist;
+    float ny = dy / dist;
+    balls_.flags[a] |= kBallTouched;
+    balls_.flags[b] |= kBallTouched;
+    float overlap = r - dist + 0.1f;
+    balls_.x[a] -= nx * overlap / 2.f;
+    balls_.y[a] -= ny * overlap / 2.f;
+    balls_.x[b] += nx * overlap / 2.f;
+    balls_.y[b] += ny * overlap / 2.f;
+
+    float& avx = balls_.vx[a];
+    float& avy = balls_.vy[a];
+    float& bvx = balls_.vx[b];
+    float& bvy = balls_.vy[b];
+    float vA = avx * nx + avy * ny;
+    float vB = bvx * nx + bvy * ny;
+    if (vA - vB > 0) {
+        float m1 = 1.f, m2 = 1.f;
+        float p = (2.f * (vA - vB)) / (m1 + m2);
+        const float k = pp.restitution();
+        avx = (avx - p * m2 * nx) * k;
+        avy = (avy - p * m2 * ny) * k;
+        bvx = (bvx + p * m1 * nx) * k;
+        bvy = (bvy + p * m1 * ny) * k;
+    }
+}
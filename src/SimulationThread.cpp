@@ -0,0 +1,182 @@
+#include "SimulationThread.hpp"
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+
+namespace {
+
+std::int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        SimulationThread::Clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+SimulationThread::SimulationThread(const TableGeometry& table, std::string logDir, const std::string& profile,
+                                   std::uint16_t spectatorPort)
+    : sim_(table), logDir_(std::move(logDir))
+{
+    sim_.setProfile(profile);
+    if (spectatorPort != 0) {
+        spectator_ = std::make_unique<SpectatorServer>(spectatorPort);
+        if (!spectator_->listening()) {
+            std::fprintf(stderr, "spectator port %u is unavailable\n", static_cast<unsigned>(spectatorPort));
+            spectator_.reset();
+        }
+    }
+    log_.begin(sim_);
+    thread_ = std::thread(&SimulationThread::run, this);
+}
+
+SimulationThread::~SimulationThread() {
+    stop_.store(true, std::memory_order_relaxed);
+    thread_.join();
+    saveLog();
+}
+
+std::uint64_t SimulationThread::send(SimCommand command) {
+    command.seq = nextSeq_++;
+    while (!commands_.push(command))
+        std::this_thread::yield();
+    return command.seq;
+}
+
+void SimulationThread::run() {
+    const std::int64_t period = static_cast<std::int64_t>(Simulation::kFixedDt * 1e9);
+    const std::int64_t maxLag = static_cast<std::int64_t>(Simulation::kMaxFrameDt * 1e9);
+    tickTimeNs_ = nowNs();
+    publish();
+
+    while (!stop_.load(std::memory_order_relaxed)) {
+        bool changed = false;
+        SimCommand command;
+        while (commands_.pop(command)) {
+            apply(command);
+            changed = true;
+        }
+
+        // Шаг на каждый положенный по расписанию тик; после долгой паузы
+        // (отладчик, сон системы) отставание отбрасывается, а не догоняется
+        std::int64_t now = nowNs();
+        if (now - tickTimeNs_ > maxLag)
+            tickTimeNs_ = now - period;
+        while (tickTimeNs_ + period <= now) {
+            bool moving = !sim_.isAtRest();
+            step();
+            tickTimeNs_ += period;
+            changed = changed || moving;
+        }
+
+        // Стол спит и команд не было — прошлое состояние ещё верно
+        if (changed || !pendingPockets_.empty())
+            publish();
+
+        // Очередь команд опрашивается раз в тик: удар ждёт не дольше одного шага
+        std::this_thread::sleep_until(Clock::time_point(
+            std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds(tickTimeNs_ + period))));
+    }
+}
+
+void SimulationThread::apply(const SimCommand& c) {
+    BallStore& balls = sim_.balls();
+    switch (c.type) {
+    case SimCommand::Shot: {
+        int i = balls.indexOf(c.ball);
+        if (i == BallStore::kNoSlot)
+            break;
+        balls.setVelocity(i, c.x * c.power, c.y * c.power);
+        log_.shot(sim_, i, c.x, c.y, c.power);
+        break;
+    }
+    case SimCommand::Respot:
+        if (balls.find(c.number) != -1 || balls.size() >= TableState::kMaxBalls)
+            break;
+        balls.push({c.x, c.y, 0.f, 0.f, c.radius, c.number});
+        log_.place(sim_, c.number);
+        prevX_[balls.size() - 1] = c.x;
+        prevY_[balls.size() - 1] = c.y;
+        break;
+    case SimCommand::Restore:
+        saveLog();
+        c.state.restore(balls);
+        sim_.resetContacts();
+        sim_.clearPocketEvents();
+        pendingPockets_.clear();
+        log_.begin(sim_);
+        if (spectator_)
+            spectator_->reset();
+        // Без интерполяции от старого стола
+        for (std::size_t i = 0; i < balls.size(); ++i) {
+            prevX_[i] = balls.x[i];
+            prevY_[i] = balls.y[i];
+        }
+        break;
+    }
+    appliedSeq_ = c.seq;
+}
+
+void SimulationThread::step() {
+    BallStore& balls = sim_.balls();
+    for (std::size_t i = 0; i < balls.size(); ++i) {
+        std::size_t slot = 2 * static_cast<std::size_t>(balls.id[i]);
+        if (prevById_.size() <= slot + 1)
+            prevById_.resize(slot + 2);
+        prevById_[slot] = balls.x[i];
+        prevById_[slot + 1] = balls.y[i];
+    }
+
+    sim_.step();
+    log_.frame(sim_);
+    ++stats_.ticks;
+    stats_.movingTicks += sim_.lastSubsteps() > 0;
+    stats_.substeps += sim_.lastSubsteps();
+    stats_.lastSubsteps = sim_.lastSubsteps();
+
+    for (std::size_t i = 0; i < balls.size(); ++i) {
+        prevX_[i] = prevById_[2 * balls.id[i]];
+        prevY_[i] = prevById_[2 * balls.id[i] + 1];
+    }
+    if (spectator_) {
+        spectator_->publish(sim_);
+        stats_.viewers = static_cast<std::uint32_t>(spectator_->viewers());
+    }
+    for (const PocketEvent& e : sim_.pocketEvents())
+        pendingPockets_.push_back({e, appliedSeq_});
+    sim_.clearPocketEvents();
+}
+
+void SimulationThread::publish() {
+    // Сначала лузы: игра читает их после снимка и должна увидеть все события до него
+    std::size_t sent = 0;
+    while (sent < pendingPockets_.size() && pockets_.push(pendingPockets_[sent]))
+        ++sent;
+    pendingPockets_.erase(pendingPockets_.begin(), pendingPockets_.begin() + sent);
+
+    // Больше kMaxBalls шаров не бывает: Respot и Restore не дают. Если всё же
+    // так — игра остаётся на прошлом снимке, а не видит обрезанный стол
+    const BallStore& balls = sim_.balls();
+    SimSnapshot& s = snapshots_.back();
+    if (!s.state.capture(balls))
+        return;
+    s.tick = sim_.tick();
+    s.tickTimeNs = tickTimeNs_;
+    s.appliedSeq = appliedSeq_;
+    s.moving = !sim_.isAtRest() || !pendingPockets_.empty();
+    s.stats = stats_;
+    for (std::size_t i = 0; i < balls.size(); ++i) {
+        s.prevX[i] = prevX_[i];
+        s.prevY[i] = prevY_[i];
+    }
+    snapshots_.publish();
+}
+
+void SimulationThread::saveLog() {
+    if (logDir_.empty() || log_.shots() == 0)
+        return;
+    log_.finish(sim_);
+    std::filesystem::create_directories(logDir_);
+    char name[64];
+    std::time_t now = std::time(nullptr);
+    std::strftime(name, sizeof(name), "/game_%Y%m%d_%H%M%S.shotlog", std::localtime(&now));
+    log_.save(logDir_ + name);
+}
@@ -0,0 +1,336 @@
+#include "SpectatorFrame.hpp"
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+struct Writer {
+    SpectatorBuffer& out;
+
+    void u8(std::uint8_t v) { out.push_back(v); }
+    void u32(std::uint32_t v) {
+        for (int i = 0; i < 4; ++i)
+            out.push_back(static_cast<std::uint8_t>(v >> (8 * i)));
+    }
+    void f32(float v) {
+        std::uint32_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        u32(bits);
+    }
+    void varint(std::uint64_t v) {
+        while (v >= 0x80) {
+            out.push_back(static_cast<std::uint8_t>(v | 0x80));
+            v >>= 7;
+        }
+        out.push_back(static_cast<std::uint8_t>(v));
+    }
+    // Знаковые: 0, -1, 1, -2... → 0, 1, 2, 3...
+    void zigzag(std::int64_t v) { varint((static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63)); }
+    void patch32(std::size_t at, std::uint32_t v) {
+        for (int i = 0; i < 4; ++i)
+            out[at + i] = static_cast<std::uint8_t>(v >> (8 * i));
+    }
+};
+
+// Чтение с проверкой границ: после первой ошибки ok становится false и остаётся
+struct Reader {
+    const std::uint8_t* p;
+    const std::uint8_t* end;
+    bool ok = true;
+
+    std::uint8_t u8() {
+        if (p >= end)
+            return fail();
+        return *p++;
+    }
+    std::uint32_t u32() {
+        if (end - p < 4)
+            return fail();
+        std::uint32_t v = 0;
+        for (int i = 0; i < 4; ++i)
+            v |= static_cast<std::uint32_t>(p[i]) << (8 * i);
+        p += 4;
+        return v;
+    }
+    float f32() {
+        std::uint32_t bits = u32();
+        float v;
+        std::memcpy(&v, &bits, sizeof(v));
+        return v;
+    }
+    std::uint64_t varint() {
+        std::uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            std::uint8_t b = u8();
+            v |= static_cast<std::uint64_t>(b & 0x7f) << shift;
+            if (!(b & 0x80))
+                return v;
+        }
+        return fail();
+    }
+    std::int64_t zigzag() {
+        std::uint64_t v = varint();
+        return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1);
+    }
+    std::uint8_t fail() {
+        ok = false;
+        p = end;
+        return 0;
+    }
+};
+
+std::int32_t quantize(float v) {
+    return static_cast<std::int32_t>(std::lround(v * SpectatorEncoder::kScale));
+}
+
+// Слагаемое контрольной суммы; сумма по шарам не зависит от их порядка
+std::uint32_t ballHash(std::uint32_t id, std::int32_t x, std::int32_t y) {
+    std::uint32_t h = id * 0x9e3779b1u ^ static_cast<std::uint32_t>(x) * 0x85ebca77u ^
+                      static_cast<std::uint32_t>(y) * 0xc2b2ae3du;
+    h ^= h >> 16;
+    h *= 0x7feb352du;
+    h ^= h >> 15;
+    return h;
+}
+
+// Предел на кадр: больше не бывает даже у стола из тысяч шаров
+constexpr std::uint32_t kMaxFrame = 1u << 20;
+
+} // namespace
+
+std::shared_ptr<const SpectatorBuffer> SpectatorEncoder::encode(const Simulation& sim) {
+    const BallStore& balls = sim.balls();
+    const TableGeometry& table = sim.table();
+    const bool key = needKey_ || sim.tick() - lastKey_ >= kKeyframeInterval;
+
+    auto qx = [&](std::size_t i) { return quantize(balls.x[i] - table.left); };
+    auto qy = [&](std::size_t i) { return quantize(balls.y[i] - table.top); };
+    auto known = [&](std::uint32_t id, int number) {
+        return id < last_.size() && last_[id].present && last_[id].number == number;
+    };
+
+    // Что изменилось с прошлого кадра: ушедшие id, новые и сдвинутые индексы
+    removed_.clear();
+    added_.clear();
+    moved_.clear();
+    if (!key) {
+        for (std::uint32_t id : ids_) {
+            int i = balls.indexOf(id);
+            if (i == BallStore::kNoSlot || balls.number[i] != last_[id].number)
+                removed_.push_back(id);
+        }
+        for (std::size_t i = 0; i < balls.size(); ++i) {
+            std::uint32_t id = balls.id[i];
+            if (!known(id, balls.number[i]))
+                added_.push_back(static_cast<std::uint32_t>(i));
+            else if (qx(i) != last_[id].x || qy(i) != last_[id].y)
+                moved_.push_back(static_cast<std::uint32_t>(i));
+        }
+        if (removed_.empty() && added_.empty() && moved_.empty())
+            return nullptr;
+    }
+
+    auto frame = std::make_shared<SpectatorBuffer>();
+    frame->reserve(64 + 12 * (key ? balls.size() : added_.size() + moved_.size()));
+    Writer w{*frame};
+    w.u32(0);
+    w.u8(static_cast<std::uint8_t>(key ? SpectatorFrame::Keyframe : SpectatorFrame::Delta));
+    w.varint(sim.tick());
+    const std::size_t checksumAt = frame->size();
+    w.u32(0);
+
+    auto writeBall = [&](std::size_t i) {
+        w.varint(balls.id[i]);
+        w.zigzag(balls.number[i]);
+        w.varint(static_cast<std::uint32_t>(quantize(balls.radius[i])));
+        w.zigzag(qx(i));
+        w.zigzag(qy(i));
+    };
+
+    if (key) {
+        w.f32(table.left);
+        w.f32(table.top);
+        w.f32(table.width);
+        w.f32(table.height);
+        w.varint(table.pockets.size());
+        for (const PocketState& p : table.pockets) {
+            w.f32(p.x);
+            w.f32(p.y);
+            w.f32(p.radius);
+        }
+        w.varint(balls.size());
+        for (std::size_t i = 0; i < balls.size(); ++i)
+            writeBall(i);
+        for (std::uint32_t id : ids_)
+            last_[id].present = false;
+        lastKey_ = sim.tick();
+        needKey_ = false;
+    } else {
+        // Дельта строится от прошлого кадра: клиент с пропуском ждёт ключевой
+        w.varint(sim.tick() - lastTick_);
+        w.varint(removed_.size());
+        for (std::uint32_t id : removed_) {
+            std::uint8_t pocket = kNoPocket;
+            for (const PocketEvent& e : sim.pocketEvents())
+                if (e.id == id)
+                    pocket = static_cast<std::uint8_t>(e.pocket);
+            w.varint(id);
+            w.u8(pocket);
+            last_[id].present = false;
+        }
+        w.varint(added_.size());
+        for (std::uint32_t i : added_)
+            writeBall(i);
+        w.varint(moved_.size());
+        for (std::uint32_t i : moved_) {
+            const Ball& was = last_[balls.id[i]];
+            w.varint(balls.id[i]);
+            w.zigzag(static_cast<std::int64_t>(qx(i)) - was.x);
+            w.zigzag(static_cast<std::int64_t>(qy(i)) - was.y);
+        }
+    }
+
+    // Запомнить, что теперь видит зритель
+    ids_.clear();
+    std::uint32_t checksum = 0;
+    for (std::size_t i = 0; i < balls.size(); ++i) {
+        std::uint32_t id = balls.id[i];
+        if (last_.size() <= id)
+            last_.resize(id + 1, Ball{0, 0, 0, false});
+        last_[id] = {qx(i), qy(i), balls.number[i], true};
+        ids_.push_back(id);
+        checksum += ballHash(id, last_[id].x, last_[id].y);
+    }
+    lastTick_ = sim.tick();
+
+    w.patch32(checksumAt, checksum);
+    w.patch32(0, static_cast<std::uint32_t>(frame->size() - kLengthSize));
+    return frame;
+}
+
+bool SpectatorDecoder::feed(const std::uint8_t* data, std::size_t size) {
+    pending_.insert(pending_.end(), data, data + size);
+    std::size_t at = 0;
+    bool ok = true;
+    while (ok && pending_.size() - at >= SpectatorEncoder::kLengthSize) {
+        std::uint32_t length = 0;
+        for (int i = 0; i < 4; ++i)
+            length |= static_cast<std::uint32_t>(pending_[at + i]) << (8 * i);
+        if (length == 0 || length > kMaxFrame) {
+            ok = false;
+            break;
+        }
+        if (pending_.size() - at - SpectatorEncoder::kLengthSize < length)
+            break;
+        ok = decode(pending_.data() + at + SpectatorEncoder::kLengthSize, length);
+        at += SpectatorEncoder::kLengthSize + length;
+    }
+    pending_.erase(pending_.begin(), pending_.begin() + static_cast<std::ptrdiff_t>(at));
+    return ok;
+}
+
+bool SpectatorDecoder::decode(const std::uint8_t* data, std::size_t size) {
+    Reader r{data, data + size};
+    auto type = static_cast<SpectatorFrame>(r.u8());
+    std::uint64_t tick = r.varint();
+    std::uint32_t checksum = r.u32();
+
+    auto ball = [&](std::uint32_t id) -> Ball& {
+        if (balls_.size() <= id)
+            balls_.resize(id + 1, Ball{0, 0, 0, 0, false});
+        return balls_[id];
+    };
+    auto readBall = [&] {
+        std::uint64_t id = r.varint();
+        int number = static_cast<int>(r.zigzag());
+        auto radius = static_cast<std::int32_t>(r.varint());
+        auto x = static_cast<std::int32_t>(r.zigzag());
+        auto y = static_cast<std::int32_t>(r.zigzag());
+        if (id >= kMaxFrame)
+            r.fail();
+        if (r.ok)
+            ball(static_cast<std::uint32_t>(id)) = {x, y, radius, number, true};
+    };
+
+    if (type == SpectatorFrame::Keyframe) {
+        for (Ball& b : balls_)
+            b.present = false;
+        table_.left = r.f32();
+        table_.top = r.f32();
+        table_.width = r.f32();
+        table_.height = r.f32();
+        std::uint64_t pockets = r.varint();
+        table_.pockets.clear();
+        for (std::uint64_t i = 0; i < pockets && r.ok; ++i) {
+            PocketState p;
+            p.x = r.f32();
+            p.y = r.f32();
+            p.radius = r.f32();
+            table_.pockets.push_back(p);
+        }
+        std::uint64_t count = r.varint();
+        for (std::uint64_t i = 0; i < count && r.ok; ++i)
+            readBall();
+        synced_ = r.ok;
+        ++keyframes_;
+    } else if (type == SpectatorFrame::Delta) {
+        std::uint64_t base = tick - r.varint();
+        if (!synced_ || base != tick_) {
+            // Пропущен кадр: стол неизвестен до следующего ключевого
+            synced_ = false;
+            ++skipped_;
+            return r.ok;
+        }
+        std::uint64_t removed = r.varint();
+        for (std::uint64_t i = 0; i < removed && r.ok; ++i) {
+            std::uint64_t id = r.varint();
+            std::uint8_t pocket = r.u8();
+            if (id < balls_.size())
+                balls_[id].present = false;
+            pocketed_ += pocket != SpectatorEncoder::kNoPocket;
+        }
+        std::uint64_t added = r.varint();
+        for (std::uint64_t i = 0; i < added && r.ok; ++i)
+            readBall();
+        std::uint64_t moved = r.varint();
+        for (std::uint64_t i = 0; i < moved && r.ok; ++i) {
+            std::uint64_t id = r.varint();
+            std::int64_t dx = r.zigzag(), dy = r.zigzag();
+            if (id >= balls_.size() || !balls_[id].present) {
+                r.fail();
+                break;
+            }
+            balls_[id].x += static_cast<std::int32_t>(dx);
+            balls_[id].y += static_cast<std::int32_t>(dy);
+        }
+    } else {
+        return false;
+    }
+
+    if (!r.ok)
+        return false;
+    tick_ = tick;
+    ++frames_;
+    mismatches_ += checksum != this->checksum();
+    return true;
+}
+
+std::vector<SpectatorBall> SpectatorDecoder::balls() const {
+    std::vector<SpectatorBall> out;
+    for (std::size_t id = 0; id < balls_.size(); ++id) {
+        const Ball& b = balls_[id];
+        if (b.present)
+            out.push_back({static_cast<std::uint32_t>(id), b.number,
+                           table_.left + b.x / SpectatorEncoder::kScale, table_.top + b.y / SpectatorEncoder::kScale,
+                           b.radius / SpectatorEncoder::kScale});
+    }
+    return out;
+}
+
+std::uint32_t SpectatorDecoder::checksum() const {
+    std::uint32_t sum = 0;
+    for (std::size_t id = 0; id < balls_.size(); ++id)
+        if (balls_[id].present)
+            sum += ballHash(static_cast<std::uint32_t>(id), balls_[id].x, balls_[id].y);
+    return sum;
+}
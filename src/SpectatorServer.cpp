@@ -0,0 +1,125 @@
+#include "SpectatorServer.hpp"
+
+SpectatorServer::SpectatorServer(std::uint16_t port)
+    : listener_(TcpSocket::listen(port))
+{
+    port_ = listener_.localPort();
+    if (listening())
+        thread_ = std::thread(&SpectatorServer::run, this);
+}
+
+SpectatorServer::~SpectatorServer() {
+    stop_.store(true, std::memory_order_relaxed);
+    if (thread_.joinable())
+        thread_.join();
+}
+
+void SpectatorServer::publish(const Simulation& sim) {
+    // Некому смотреть — первый зритель начнёт с ключевого кадра
+    if (viewers() == 0) {
+        encoder_.reset();
+        return;
+    }
+    if (wantKey_.exchange(false, std::memory_order_relaxed))
+        encoder_.reset();
+    std::shared_ptr<const SpectatorBuffer> frame = encoder_.encode(sim);
+    if (!frame)
+        return;
+    // Сетевой поток не успевает разбирать очередь: кадр теряется у всех,
+    // следующий — ключевой
+    if (!frames_.push(frame)) {
+        framesDropped_.fetch_add(1, std::memory_order_relaxed);
+        encoder_.reset();
+    }
+}
+
+void SpectatorServer::run() {
+    std::vector<SocketWait> wait;
+    while (!stop_.load(std::memory_order_relaxed)) {
+        Frame frame;
+        while (frames_.pop(frame))
+            enqueue(frame);
+        frame.reset();
+
+        // Сначала отправить сразу, ждать готовности — только тем, у кого осталось
+        for (Viewer& v : viewers_)
+            if (!flush(v))
+                v.socket.close();
+
+        wait.clear();
+        wait.push_back({&listener_, true, false});
+        for (const Viewer& v : viewers_)
+            wait.push_back({&v.socket, true, !v.queue.empty()});
+        waitSockets(wait, kPollMs);
+
+        for (std::size_t i = 0; i < viewers_.size(); ++i) {
+            Viewer& v = viewers_[i];
+            const SocketWait& w = wait[i + 1];
+            if (!v.socket.valid())
+                continue;
+            // Зрители ничего не шлют: чтение ловит только отключение
+            std::uint8_t scratch[256];
+            if (w.readable && v.socket.recv(scratch, sizeof(scratch)) < 0)
+                v.socket.close();
+            else if (w.writable && !flush(v))
+                v.socket.close();
+            else if (w.failed && !w.readable)
+                v.socket.close();
+        }
+        for (std::size_t i = viewers_.size(); i-- > 0;)
+            if (!viewers_[i].socket.valid())
+                viewers_.erase(viewers_.begin() + static_cast<std::ptrdiff_t>(i));
+
+        if (wait[0].readable)
+            for (TcpSocket s = listener_.accept(); s.valid(); s = listener_.accept()) {
+                viewers_.emplace_back();
+                viewers_.back().socket = std::move(s);
+                viewers_.back().socket.setBuffers(kSocketBuffer, 0);
+                wantKey_.store(true, std::memory_order_relaxed);
+            }
+        viewerCount_.store(viewers_.size(), std::memory_order_relaxed);
+    }
+}
+
+void SpectatorServer::enqueue(const Frame& frame) {
+    const bool key = SpectatorEncoder::type(*frame) == SpectatorFrame::Keyframe;
+    for (Viewer& v : viewers_) {
+        // Дельты без своего ключевого кадра зрителю бесполезны
+        if (v.waitKey && !key)
+            continue;
+        v.waitKey = false;
+        v.queue.push_back(frame);
+        v.backlog += frame->size();
+        if (v.backlog <= kMaxBacklog)
+            continue;
+
+        // Зритель не успевает: очередь сбрасывается, кроме начатого кадра —
+        // его надо дослать, чтобы не разорвать поток
+        std::size_t keep = v.offset > 0 ? 1 : 0;
+        framesDropped_.fetch_add(v.queue.size() - keep, std::memory_order_relaxed);
+        v.queue.resize(keep);
+        v.backlog = keep ? v.queue.front()->size() - v.offset : 0;
+        v.waitKey = true;
+        wantKey_.store(true, std::memory_order_relaxed);
+    }
+}
+
+bool SpectatorServer::flush(Viewer& v) {
+    while (!v.queue.empty()) {
+        const SpectatorBuffer& f = *v.queue.front();
+        long sent = v.socket.send(f.data() + v.offset, f.size() - v.offset);
+        if (sent < 0)
+            return false;
+        if (sent == 0)
+            return true;
+        v.offset += static_cast<std::size_t>(sent);
+        v.backlog -= static_cast<std::size_t>(sent);
+        bytesSent_.fetch_add(static_cast<std::uint64_t>(sent), std::memory_order_relaxed);
+        if (v.offset == f.size()) {
+            v.queue.pop_front();
+            v.offset = 0;
+            framesSent_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,35 @@
+#include "TableLayout.hpp"
+#include <cmath>
+
+TableGeometry TableLayout::geometry() const {
+    return {x, y, width, height, {
+        {x, y, pocketRadius},
+        {x + width / 2, y, pocketRadius},
+        {x + width, y, pocketRadius},
+        {x, y + height, pocketRadius},
+        {x + width / 2, y + height, pocketRadius},
+        {x + width, y + height, pocketRadius},
+    }};
+}
+
+void TableLayout::rack(BallStore& balls) const {
+    balls.clear();
+    // Cue ball (white, number 0)
+    balls.push({x + width*0.25f, y + height/2, 0.f, 0.f, ballRadius, 0});
+    // Classic 15-ball pyramid (rows tight)
+    float x0 = x + width*0.75f;
+    float y0 = y + height/2;
+    int k = 1;
+    float dy = ballRadius * 2 * std::sin(3.1415926 / 3.0);
+    for (int row = 0; row < 5; ++row) {
+        float yStart = y0 - dy * (row / 2.0f);
+        for (int col = 0; col <= row; ++col) {
+            float bx = x0 + row * ballRadius * 2 * std::cos(3.1415926 / 6);
+            float by = yStart + col * dy;
+            balls.push({bx, by, 0.f, 0.f, ballRadius, k});
+            ++k;
+            if (k > ballsCount) break;
+        }
+        if (k > ballsCount) break;
+    }
+}
@@ -0,0 +1,105 @@
+#include "TableRenderer.hpp"
+#include <array>
+#include <cmath>
+
+TableRenderer::TableRenderer(const TableLayout& layout, const BallAtlas& atlas, float borderThickness, float borderShadow)
+    : static_(sf::Triangles), dynamic_(sf::Triangles), faces_(sf::Triangles), atlas_(&atlas)
+{
+    const float pi = 3.14159265f;
+    unit_.reserve(kCircleSegments + 1);
+    for (std::size_t k = 0; k <= kCircleSegments; ++k) {
+        float a = 2.f * pi * k / kCircleSegments - pi / 2.f;
+        unit_.push_back({std::cos(a), std::sin(a)});
+    }
+
+    float x = layout.x, y = layout.y, w = layout.width, h = layout.height;
+    float t = borderThickness;
+    std::array<sf::FloatRect, 4> borders = {
+        sf::FloatRect(x - t, y - t, w + 2*t, t),
+        sf::FloatRect(x - t, y + h, w + 2*t, t),
+        sf::FloatRect(x - t, y, t, h),
+        sf::FloatRect(x + w, y, t, h)
+    };
+
+    // Порядок тот же, что был у отдельных фигур: тени, обводки, борта, лузы
+    for (const auto& b : borders)
+        appendRect(static_, {b.left, b.top + b.height - borderShadow, b.width, b.height}, sf::Color(55, 27, 10, 70));
+    for (const auto& b : borders) {
+        appendRect(static_, {b.left - 2.f, b.top - 2.f, b.width + 4.f, b.height + 4.f}, sf::Color(110, 65, 25));
+        appendRect(static_, b, sf::Color(90, 45, 20));
+    }
+
+    for (const auto& p : layout.geometry().pockets) {
+        sf::Vector2f c(p.x, p.y);
+        appendCircle(static_, unit_, c, p.radius + 5.f, sf::Color(0, 0, 0, 60));
+        appendCircle(static_, unit_, c, p.radius + 2.f, sf::Color(38, 20, 10, 200));
+        appendCircle(static_, unit_, c, p.radius, sf::Color(10, 10, 10, 255));
+    }
+}
+
+void TableRenderer::beginFrame() {
+    dynamic_.clear();
+    faces_.clear();
+}
+
+void TableRenderer::addCircle(sf::Vector2f center, float radius, sf::Color color) {
+    appendCircle(dynamic_, unit_, center, radius, color);
+}
+
+void TableRenderer::addShadow(sf::Vector2f center, float radius) {
+    appendCircle(dynamic_, unit_, center + sf::Vector2f(3.f, 5.f), radius, sf::Color(25, 30, 20, 80));
+}
+
+void TableRenderer::addBall(sf::Vector2f center, float radius, int number, sf::Uint8 alpha) {
+    float h = atlas_->halfExtent(number, radius);
+    sf::FloatRect uv = atlas_->face(number);
+    sf::Color tint(255, 255, 255, alpha);
+    sf::Vertex a(center + sf::Vector2f(-h, -h), tint, {uv.left, uv.top});
+    sf::Vertex b(center + sf::Vector2f(h, -h), tint, {uv.left + uv.width, uv.top});
+    sf::Vertex c(center + sf::Vector2f(h, h), tint, {uv.left + uv.width, uv.top + uv.height});
+    sf::Vertex d(center + sf::Vector2f(-h, h), tint, {uv.left, uv.top + uv.height});
+    for (const sf::Vertex& v : {a, b, c, a, c, d})
+        faces_.append(v);
+}
+
+void TableRenderer::addPath(const std::vector<PathPoint>& points, float width, sf::Color color) {
+    for (std::size_t k = 0; k + 1 < points.size(); ++k) {
+        sf::Vector2f a(points[k].x, points[k].y);
+        sf::Vector2f b(points[k + 1].x, points[k + 1].y);
+        sf::Vector2f d = b - a;
+        float len = std::hypot(d.x, d.y);
+        if (len < 1e-3f)
+            continue;
+        sf::Vector2f n(-d.y / len * width / 2.f, d.x / len * width / 2.f);
+        for (sf::Vector2f v : {a + n, b + n, b - n, a + n, b - n, a - n})
+            dynamic_.append(sf::Vertex(v, color));
+    }
+}
+
+void TableRenderer::drawStatic(sf::RenderTarget& target) const {
+    target.draw(static_);
+}
+
+void TableRenderer::drawDynamic(sf::RenderTarget& target) const {
+    target.draw(dynamic_);
+    target.draw(faces_, sf::RenderStates(&atlas_->texture()));
+}
+
+void TableRenderer::appendCircle(sf::VertexArray& va, const std::vector<sf::Vector2f>& unit,
+                                 sf::Vector2f center, float radius, sf::Color color) {
+    // Веер из треугольников, развёрнутый в список, чтобы круги шли одним массивом
+    for (std::size_t k = 0; k + 1 < unit.size(); ++k) {
+        va.append(sf::Vertex(center, color));
+        va.append(sf::Vertex(center + unit[k] * radius, color));
+        va.append(sf::Vertex(center + unit[k + 1] * radius, color));
+    }
+}
+
+void TableRenderer::appendRect(sf::VertexArray& va, sf::FloatRect rect, sf::Color color) {
+    sf::Vector2f a(rect.left, rect.top);
+    sf::Vector2f b(rect.left + rect.width, rect.top);
+    sf::Vector2f c(rect.left + rect.width, rect.top + rect.height);
+    sf::Vector2f d(rect.left, rect.top + rect.height);
+    for (sf::Vector2f v : {a, b, c, a, c, d})
+        va.append(sf::Vertex(v, color));
+}
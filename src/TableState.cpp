@@ -0,0 +1,104 @@
+#include "TableState.hpp"
+#include <cstring>
+
+bool TableState::capture(const BallStore& balls) {
+    if (!fits(balls))
+        return false;
+    std::size_t n = balls.size();
+    ballCount = static_cast<std::uint32_t>(n);
+    std::memcpy(x, balls.x.data(), n * sizeof(float));
+    std::memcpy(y, balls.y.data(), n * sizeof(float));
+    std::memcpy(vx, balls.vx.data(), n * sizeof(float));
+    std::memcpy(vy, balls.vy.data(), n * sizeof(float));
+    std::memcpy(radius, balls.radius.data(), n * sizeof(float));
+    std::memcpy(number, balls.number.data(), n * sizeof(std::int32_t));
+    std::memcpy(flags, balls.flags.data(), n * sizeof(std::uint8_t));
+    std::memcpy(id, balls.id.data(), n * sizeof(std::uint32_t));
+
+    onTable = 0;
+    for (std::size_t i = 0; i < n; ++i)
+        if (number[i] >= 0 && number[i] < 32)
+            onTable |= 1u << number[i];
+    return true;
+}
+
+void TableState::restore(BallStore& balls) const {
+    std::size_t n = ballCount;
+    balls.x.resize(n);
+    balls.y.resize(n);
+    balls.vx.resize(n);
+    balls.vy.resize(n);
+    balls.radius.resize(n);
+    balls.number.resize(n);
+    balls.flags.resize(n);
+    balls.id.resize(n);
+    std::memcpy(balls.x.data(), x, n * sizeof(float));
+    std::memcpy(balls.y.data(), y, n * sizeof(float));
+    std::memcpy(balls.vx.data(), vx, n * sizeof(float));
+    std::memcpy(balls.vy.data(), vy, n * sizeof(float));
+    std::memcpy(balls.radius.data(), radius, n * sizeof(float));
+    std::memcpy(balls.number.data(), number, n * sizeof(std::int32_t));
+    std::memcpy(balls.flags.data(), flags, n * sizeof(std::uint8_t));
+    std::memcpy(balls.id.data(), id, n * sizeof(std::uint32_t));
+    balls.reindex();
+}
+
+TableStateArena::TableStateArena(std::size_t blocksPerPage)
+    : blocksPerPage_(blocksPerPage ? blocksPerPage : 1) {}
+
+TableState* TableStateArena::acquire() {
+    if (free_.empty()) {
+        pages_.emplace_back(new TableState[blocksPerPage_]);
+        TableState* page = pages_.back().get();
+        for (std::size_t i = blocksPerPage_; i-- > 0;)
+            free_.push_back(page + i);
+    }
+    TableState* state = free_.back();
+    free_.pop_back();
+    ++live_;
+    return state;
+}
+
+void TableStateArena::release(TableState* state) {
+    if (!state)
+        return;
+    free_.push_back(state);
+    --live_;
+}
+
+UndoHistory::UndoHistory(TableStateArena& arena, std::size_t depth)
+    : arena_(arena), ring_(depth ? depth : 1, nullptr) {}
+
+UndoHistory::~UndoHistory() {
+    clear();
+}
+
+TableState& UndoHistory::push() {
+    if (size_ == ring_.size()) {
+        arena_.release(at(0));
+        bottom_ = (bottom_ + 1) % ring_.size();
+        --size_;
+    }
+    TableState*& slot = at(size_++);
+    slot = arena_.acquire();
+    return *slot;
+}
+
+bool UndoHistory::pop(TableState& out) {
+    if (size_ == 0)
+        return false;
+    TableState*& top = at(--size_);
+    out = *top;
+    arena_.release(top);
+    top = nullptr;
+    return true;
+}
+
+void UndoHistory::clear() {
+    for (std::size_t k = 0; k < size_; ++k) {
+        arena_.release(at(k));
+        at(k) = nullptr;
+    }
+    bottom_ = 0;
+    size_ = 0;
+}
@@ -0,0 +1,188 @@
+#include "TcpSocket.hpp"
+
+#if defined(_WIN32)
+#if !defined(_WIN32_WINNT) || _WIN32_WINNT < 0x0600
+#undef _WIN32_WINNT
+#define _WIN32_WINNT 0x0600     // WSAPoll
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#if defined(_WIN32)
+
+using Native = SOCKET;
+constexpr int kSendFlags = 0;
+
+bool startup() {
+    static const bool ok = [] {
+        WSADATA data;
+        return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }();
+    return ok;
+}
+
+bool wouldBlock()               { return WSAGetLastError() == WSAEWOULDBLOCK; }
+void closeNative(Native s)      { closesocket(s); }
+
+void setNonBlocking(Native s) {
+    u_long on = 1;
+    ioctlsocket(s, FIONBIO, &on);
+}
+
+int pollNative(pollfd* fds, std::size_t count, int timeoutMs) {
+    return WSAPoll(fds, static_cast<ULONG>(count), timeoutMs);
+}
+
+#else
+
+using Native = int;
+// Записи в закрытый зрителем сокет не должны ронять процесс SIGPIPE
+constexpr int kSendFlags = MSG_NOSIGNAL;
+
+bool startup()                  { return true; }
+bool wouldBlock()               { return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR; }
+void closeNative(Native s)      { ::close(s); }
+
+void setNonBlocking(Native s) {
+    fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) | O_NONBLOCK);
+}
+
+int pollNative(pollfd* fds, std::size_t count, int timeoutMs) {
+    return ::poll(fds, static_cast<nfds_t>(count), timeoutMs);
+}
+
+#endif
+
+Native native(std::intptr_t h) { return static_cast<Native>(h); }
+
+sockaddr_in loopback(std::uint16_t port) {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    return addr;
+}
+
+// Кадры мелкие и ждать их склейки нельзя
+void noDelay(Native s) {
+    int on = 1;
+    setsockopt(s, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&on), sizeof(on));
+}
+
+} // namespace
+
+TcpSocket& TcpSocket::operator=(TcpSocket&& other) noexcept {
+    if (this != &other) {
+        close();
+        handle_ = other.handle_;
+        other.handle_ = kInvalid;
+    }
+    return *this;
+}
+
+TcpSocket TcpSocket::listen(std::uint16_t port) {
+    if (!startup())
+        return {};
+    Native s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    TcpSocket result(static_cast<std::intptr_t>(s));
+    if (s == static_cast<Native>(kInvalid))
+        return {};
+    int on = 1;
+    setsockopt(s, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&on), sizeof(on));
+    sockaddr_in addr = loopback(port);
+    if (bind(s, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(s, 8) != 0)
+        return {};
+    setNonBlocking(s);
+    return result;
+}
+
+TcpSocket TcpSocket::connect(std::uint16_t port) {
+    if (!startup())
+        return {};
+    Native s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    TcpSocket result(static_cast<std::intptr_t>(s));
+    if (s == static_cast<Native>(kInvalid))
+        return {};
+    sockaddr_in addr = loopback(port);
+    if (::connect(s, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0)
+        return {};
+    setNonBlocking(s);
+    noDelay(s);
+    return result;
+}
+
+TcpSocket TcpSocket::accept() const {
+    if (!valid())
+        return {};
+    Native s = ::accept(native(handle_), nullptr, nullptr);
+    if (s == static_cast<Native>(kInvalid))
+        return {};
+    setNonBlocking(s);
+    noDelay(s);
+    return TcpSocket(static_cast<std::intptr_t>(s));
+}
+
+std::uint16_t TcpSocket::localPort() const {
+    sockaddr_in addr{};
+    socklen_t size = sizeof(addr);
+    if (!valid() || getsockname(native(handle_), reinterpret_cast<sockaddr*>(&addr), &size) != 0)
+        return 0;
+    return ntohs(addr.sin_port);
+}
+
+void TcpSocket::setBuffers(std::size_t send, std::size_t receive) {
+    int sizes[2] = {static_cast<int>(send), static_cast<int>(receive)};
+    const int options[2] = {SO_SNDBUF, SO_RCVBUF};
+    for (int i = 0; i < 2; ++i)
+        if (valid() && sizes[i] > 0)
+            setsockopt(native(handle_), SOL_SOCKET, options[i], reinterpret_cast<const char*>(&sizes[i]),
+                       sizeof(sizes[i]));
+}
+
+void TcpSocket::close() {
+    if (valid())
+        closeNative(native(handle_));
+    handle_ = kInvalid;
+}
+
+long TcpSocket::send(const void* data, std::size_t size) {
+    long n = ::send(native(handle_), static_cast<const char*>(data), static_cast<int>(size), kSendFlags);
+    if (n < 0)
+        return wouldBlock() ? 0 : -1;
+    return n;
+}
+
+long TcpSocket::recv(void* data, std::size_t size) {
+    long n = ::recv(native(handle_), static_cast<char*>(data), static_cast<int>(size), 0);
+    if (n < 0)
+        return wouldBlock() ? 0 : -1;
+    return n > 0 ? n : -1;
+}
+
+int waitSockets(std::vector<SocketWait>& sockets, int timeoutMs) {
+    std::vector<pollfd> fds(sockets.size());
+    for (std::size_t i = 0; i < sockets.size(); ++i) {
+        fds[i].fd = native(sockets[i].socket->handle());
+        fds[i].events = static_cast<short>((sockets[i].read ? POLLIN : 0) | (sockets[i].write ? POLLOUT : 0));
+    }
+    int ready = pollNative(fds.data(), fds.size(), timeoutMs);
+    for (std::size_t i = 0; i < sockets.size(); ++i) {
+        SocketWait& w = sockets[i];
+        w.readable = ready > 0 && (fds[i].revents & POLLIN);
+        w.writable = ready > 0 && (fds[i].revents & POLLOUT);
+        w.failed = ready > 0 && (fds[i].revents & (POLLERR | POLLHUP | POLLNVAL));
+    }
+    return ready;
+}
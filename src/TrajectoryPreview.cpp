@@ -0,0 +1,137 @@
+#include "TrajectoryPreview.hpp"
+#include <cmath>
+#include <cstring>
+
+TrajectoryPreview::TrajectoryPreview(const TableGeometry& table, const std::string& profile) : sim_(table) {
+    sim_.setProfile(profile);
+}
+
+bool TrajectoryPreview::sameTable(const TableState& a, const TableState& b) {
+    std::size_t n = a.ballCount;
+    return n == b.ballCount
+        && std::memcmp(a.x, b.x, n * sizeof(float)) == 0
+        && std::memcmp(a.y, b.y, n * sizeof(float)) == 0
+        && std::memcmp(a.vx, b.vx, n * sizeof(float)) == 0
+        && std::memcmp(a.vy, b.vy, n * sizeof(float)) == 0
+        && std::memcmp(a.id, b.id, n * sizeof(std::uint32_t)) == 0;
+}
+
+void TrajectoryPreview::aim(const TableState& table, std::size_t ball, float dirX, float dirY, float power) {
+    const float pi = 3.14159265f;
+    float angle = std::atan2(dirY, dirX);
+    float turn = std::fabs(angle - angle_);
+    turn = std::fmin(turn, 2.f * pi - turn);
+    bool same = active_ && ball == ball_ && sameTable(table, base_)
+        && turn <= kAngleTolerance
+        && std::fabs(power - power_) <= kPowerTolerance * power_;
+    if (same)
+        return;
+
+    base_ = table;
+    ball_ = ball;
+    dirX_ = dirX;
+    dirY_ = dirY;
+    power_ = power;
+    angle_ = angle;
+    restart();
+}
+
+void TrajectoryPreview::clear() {
+    active_ = false;
+    complete_ = false;
+    paths_.clear();
+    heading_.clear();
+}
+
+void TrajectoryPreview::restart() {
+    BallStore& balls = sim_.balls();
+    base_.restore(balls);
+    sim_.resetContacts();
+    sim_.clearPocketEvents();
+    active_ = ball_ < balls.size();
+    complete_ = !active_;
+    contact_ = false;
+    steps_ = 0;
+    paths_.clear();
+    heading_.clear();
+    if (!active_)
+        return;
+
+    balls.setVelocity(ball_, dirX_ * power_, dirY_ * power_);
+    PathPoint p{balls.x[ball_], balls.y[ball_]};
+    paths_.push_back({balls.id[ball_], balls.number[ball_], false, {p, p}});
+    heading_.push_back({balls.vx[ball_], balls.vy[ball_]});
+}
+
+bool TrajectoryPreview::advance(std::chrono::microseconds budget) {
+    using Clock = std::chrono::steady_clock;
+    const auto deadline = Clock::now() + budget;
+    // Часы — раз в несколько шагов: шаг стоит единицы микросекунд
+    while (!complete_) {
+        for (int k = 0; k < 8 && !complete_; ++k)
+            step();
+        if (Clock::now() >= deadline)
+            break;
+    }
+    return complete_;
+}
+
+void TrajectoryPreview::step() {
+    sim_.step();
+    ++steps_;
+    const BallStore& balls = sim_.balls();
+
+    for (const PocketEvent& e : sim_.pocketEvents())
+        for (auto& path : paths_)
+            if (path.id == e.id) {
+                path.pocketed = true;
+                path.points.back() = {e.x, e.y};
+            }
+    sim_.clearPocketEvents();
+
+    for (std::size_t k = 0; k < paths_.size(); ++k)
+        if (!paths_[k].pocketed)
+            track(paths_[k], k);
+
+    // Первое касание: все шары, оказавшиеся вплотную к битому на этом шаге
+    int s = balls.indexOf(paths_.front().id);
+    if (!contact_ && s != BallStore::kNoSlot) {
+        for (std::size_t j = 0; j < balls.size(); ++j) {
+            if (static_cast<int>(j) == s)
+                continue;
+            float dx = balls.x[j] - balls.x[s];
+            float dy = balls.y[j] - balls.y[s];
+            float reach = balls.radius[j] + balls.radius[s] + kContactSlack;
+            if (dx * dx + dy * dy < reach * reach) {
+                PathPoint p{balls.x[j], balls.y[j]};
+                paths_.push_back({balls.id[j], balls.number[j], false, {p, p}});
+                heading_.push_back({balls.vx[j], balls.vy[j]});
+                contact_ = true;
+            }
+        }
+    }
+
+    complete_ = sim_.isAtRest() || steps_ >= kMaxSteps;
+}
+
+void TrajectoryPreview::track(PredictedPath& path, std::size_t slot) {
+    const BallStore& balls = sim_.balls();
+    int i = balls.indexOf(path.id);
+    if (i == BallStore::kNoSlot)
+        return;
+    PathPoint p{balls.x[i], balls.y[i]};
+    float vx = balls.vx[i], vy = balls.vy[i];
+    PathPoint& h = heading_[slot];
+
+    float dot = vx * h.x + vy * h.y;
+    float mag = std::sqrt((vx * vx + vy * vy) * (h.x * h.x + h.y * h.y));
+    if (mag > 0.f && dot < kTurnCos * mag) {
+        // Излом: текущая точка фиксируется, за ней тянется новый конец
+        path.points.back() = p;
+        path.points.push_back(p);
+        h = {vx, vy};
+    } else if (h.x == 0.f && h.y == 0.f) {
+        h = {vx, vy};
+    }
+    path.points.back() = p;
+}
@@ -0,0 +1,109 @@
+#include "WorkStealingPool.hpp"
+#include <algorithm>
+
+WorkStealingPool::WorkStealingPool(unsigned threads) {
+    threads = std::max(threads, 1u);
+    for (unsigned i = 0; i < threads; ++i)
+        ranges_.push_back(std::make_unique<Range>());
+    for (unsigned i = 1; i < threads; ++i)
+        threads_.emplace_back(&WorkStealingPool::workerLoop, this, i);
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& t : threads_)
+        t.join();
+}
+
+void WorkStealingPool::parallelFor(std::size_t count, const Task& fn) {
+    if (count == 0)
+        return;
+
+    const std::size_t n = ranges_.size();
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        for (std::size_t w = 0; w < n; ++w) {
+            std::lock_guard<std::mutex> rl(ranges_[w]->m);
+            ranges_[w]->begin = count * w / n;
+            ranges_[w]->end = count * (w + 1) / n;
+        }
+        task_ = &fn;
+        busy_ = static_cast<unsigned>(n);
+        ++generation_;
+    }
+    wake_.notify_all();
+
+    drain(0);
+
+    std::unique_lock<std::mutex> lock(m_);
+    --busy_;
+    done_.wait(lock, [this] { return busy_ == 0; });
+    task_ = nullptr;
+}
+
+void WorkStealingPool::workerLoop(unsigned id) {
+    std::uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_);
+            wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_)
+                return;
+            seen = generation_;
+        }
+        drain(id);
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            if (--busy_ == 0)
+                done_.notify_all();
+        }
+    }
+}
+
+// Диапазоны только сокращаются: красть нечего — значит, всё уже разобрано.
+// Чужие задачи не ждём, parallelFor дождётся всех по busy_
+void WorkStealingPool::drain(unsigned id) {
+    std::size_t index;
+    for (;;) {
+        if (popOwn(id, index))
+            (*task_)(index, id);
+        else if (!steal(id))
+            return;
+    }
+}
+
+bool WorkStealingPool::popOwn(unsigned id, std::size_t& index) {
+    Range& r = *ranges_[id];
+    std::lock_guard<std::mutex> lock(r.m);
+    if (r.begin >= r.end)
+        return false;
+    index = r.begin++;
+    return true;
+}
+
+bool WorkStealingPool::steal(unsigned id) {
+    const unsigned n = size();
+    for (unsigned k = 1; k < n; ++k) {
+        Range& victim = *ranges_[(id + k) % n];
+        std::size_t from, to;
+        {
+            std::lock_guard<std::mutex> lock(victim.m);
+            if (victim.begin >= victim.end)
+                continue;
+            std::size_t take = (victim.end - victim.begin + 1) / 2;
+            to = victim.end;
+            from = victim.end - take;
+            victim.end = from;
+        }
+        Range& own = *ranges_[id];
+        std::lock_guard<std::mutex> lock(own.m);
+        own.begin = from;
+        own.end = to;
+        return true;
+    }
+    return false;
+}
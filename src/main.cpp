@@ -1,38 +1,55 @@
 #include <SFML/Graphics.hpp>
 #include <vector>
 #include <cmath>
-#include <array>
 #include <algorithm>
 #include <string>
 #include <memory>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
 #include "Table.hpp"
 #include "Ball.hpp"
 #include "Physics.hpp"
 #include "Cue.hpp"
 #include "Pocket.hpp"
+#include "ClothTexture.hpp"
+#include "FrameProfiler.hpp"
+#include "GameRules.hpp"
+#include "ShotSolver.hpp"
+#include "TableLayout.hpp"
+#include "TableRenderer.hpp"
+#include "TableState.hpp"
+#include "TrajectoryPreview.hpp"
 
 struct FallingBall {
     sf::Vector2f pos;
     float radius;
-    sf::Color color;
     int number;
     float t;
-    sf::Font* font;
 };
 
 const sf::Color ivory(232, 229, 203);
 const sf::Color cueBallColor = sf::Color(255, 255, 255);
 
-sf::Color gradientColor(sf::Color a, sf::Color b, float t) {
-    return sf::Color(
-        static_cast<sf::Uint8>(a.r + (b.r - a.r) * t),
-        static_cast<sf::Uint8>(a.g + (b.g - a.g) * t),
-        static_cast<sf::Uint8>(a.b + (b.b - a.b) * t),
-        static_cast<sf::Uint8>(a.a + (b.a - a.a) * t)
-    );
-}
-
-int main() {
+int main(int argc, char** argv) {
+    sf::Clock startupClock;
+
+    // Table physics profile: --profile pyramid|pool|snooker;
+    // --spectate PORT streams the table to local viewers (tools/spectator)
+    std::string profile = PyramidProfile::kName;
+    std::uint16_t spectatorPort = 0;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--profile") == 0)
+            profile = argv[++i];
+        else if (std::strcmp(argv[i], "--spectate") == 0)
+            spectatorPort = static_cast<std::uint16_t>(std::atoi(argv[++i]));
+    }
+    if (!findPhysicsProfile(profile)) {
+        std::fprintf(stderr, "unknown physics profile '%s', using %s\n", profile.c_str(), PyramidProfile::kName);
+        profile = PyramidProfile::kName;
+    }
     constexpr int windowWidth = 1024;
     constexpr int windowHeight = 600;
 
@@ -50,51 +67,56 @@ int main() {
         return 1;
     }
 
-    // Game state
-    int player = 1;
-    int score1 = 0, score2 = 0;
-    int ballsToWin = 8;
     int ballsCount = 15;
 
-    // Ball reset function
-    auto reset_balls = [&](std::vector<Ball>& balls) {
-        balls.clear();
-        // Cue ball (white, number 0)
-        balls.emplace_back(tableX + tableW*0.25f, tableY + tableH/2, ballRadius, cueBallColor, 0, &font);
-        // Classic 15-ball pyramid (rows tight)
-        float x0 = tableX + tableW*0.75f;
-        float y0 = tableY + tableH/2;
-        int k = 1;
-        float dy = ballRadius * 2 * std::sin(3.1415926 / 3.0);
-        for (int row = 0; row < 5; ++row) {
-            float yStart = y0 - dy * (row / 2.0f);
-            for (int col = 0; col <= row; ++col) {
-                float x = x0 + row * ballRadius * 2 * std::cos(3.1415926 / 6);
-                float y = yStart + col * dy;
-                balls.emplace_back(x, y, ballRadius, ivory, k, &font);
-                ++k;
-                if (k > ballsCount) break;
-            }
-            if (k > ballsCount) break;
-        }
-    };
+    // Ball looks, indexed by ball number
+    std::vector<Ball> ballLooks;
+    ballLooks.emplace_back(ballRadius, cueBallColor, 0, &font);
+    for (int k = 1; k <= ballsCount; ++k)
+        ballLooks.emplace_back(ballRadius, ivory, k, &font);
 
-    std::vector<Ball> balls;
-    reset_balls(balls);
+    TableLayout layout{tableX, tableY, tableW, tableH, ballRadius, pocketRadius, ballsCount};
 
-    std::vector<Pocket> pockets = {
-        { {tableX, tableY}, pocketRadius },
-        { {tableX + tableW / 2, tableY}, pocketRadius },
-        { {tableX + tableW, tableY}, pocketRadius },
-        { {tableX, tableY + tableH}, pocketRadius },
-        { {tableX + tableW / 2, tableY + tableH}, pocketRadius },
-        { {tableX + tableW, tableY + tableH}, pocketRadius }
-    };
+    // Ball faces are baked once; frames draw them as textured quads
+    BallAtlas atlas(ballLooks);
+    TableRenderer renderer(layout, atlas, borderThickness, borderShadow);
+
+    std::vector<Pocket> pockets;
+    for (const auto& p : layout.geometry().pockets)
+        pockets.push_back({{p.x, p.y}, p.radius});
 
     Table table(tableX, tableY, tableW, tableH);
-    std::unique_ptr<PhysicsEngine> physics = std::make_unique<PhysicsEngine>(balls, table, pockets);
+    // Physics runs on its own thread at a fixed 240 Hz; `balls` is the latest snapshot,
+    // interpolated for rendering. Every game is recorded to ../replays by the physics thread
+    // (a new log starts on each restore); tools/replay re-simulates the logs headless
+    std::unique_ptr<PhysicsEngine> physics = std::make_unique<PhysicsEngine>(table, pockets, "../replays", profile,
+                                                                             spectatorPort);
+    const BallStore& balls = physics->balls();
+    auto reset_balls = [&]() {
+        BallStore rack;
+        layout.rack(rack);
+        TableState state;
+        if (!state.capture(rack)) {
+            std::fprintf(stderr, "a rack of %zu balls doesn't fit a table snapshot (max %zu)\n", rack.size(),
+                         TableState::kMaxBalls);
+            return;
+        }
+        physics->restore(state);
+    };
+    reset_balls();
     Cue cue;
 
+    // Shot hint: best shot found within one frame's budget
+    WorkStealingPool pool;
+    ShotSolver solver(pool);
+    bool hintVisible = false;
+    ShotOutcome hint{};
+    std::uint32_t hintBall = 0;     // stable id: indices move when balls are pocketed
+
+    // Aiming preview: the game's own physics run ahead on a copy of the table, ~1 ms per frame
+    TrajectoryPreview preview(layout.geometry(), profile);
+    const auto previewBudget = std::chrono::microseconds(1000);
+
     bool dragging = false;
     sf::Vector2f dragStart;
     sf::Vector2f dragEnd;
@@ -106,14 +128,21 @@ int main() {
     float minCueLen = 10.f;
     float maxCueLen = 220.f;
     float hitTolerance = 4.f;
-    bool ballsMoving = false;
-    bool anyScored = false;
-    bool cuePocketed = false;
-    sf::Vector2f cueBallStartPos = balls[0].getPosition();
+    // Score, turn and the cue ball's spot; the rules live in GameState
+    GameState game;
+    game.reset(balls.x[0], balls.y[0]);
     sf::Clock winClock;
     bool gameJustWon = false;
     int winnerPlayer = 0;
 
+    // Undo: a flat snapshot of the table is pushed before every shot
+    TableStateArena stateArena;
+    UndoHistory undo(stateArena);
+    auto saveState = [&](TableState& state) {
+        state = physics->state();
+        game.save(state);
+    };
+
     struct AnimatedFalling {
         FallingBall ball;
         float elapsed = 0.f;
@@ -123,18 +152,14 @@ int main() {
 
     sf::Clock clock;
 
+    // Cloth gradient: generated in parallel on the first launch, loaded from the cache afterwards
+    ClothParams clothParams;
+    clothParams.width = static_cast<unsigned int>(tableW);
+    clothParams.height = static_cast<unsigned int>(tableH);
+    std::vector<std::uint8_t> clothPixels = loadOrGenerateCloth("../cache", clothParams, &pool);
     sf::Texture clothOverlay;
-    clothOverlay.create(static_cast<unsigned int>(tableW), static_cast<unsigned int>(tableH));
-    sf::Image overlayImg;
-    overlayImg.create(static_cast<unsigned int>(tableW), static_cast<unsigned int>(tableH));
-    for (unsigned int y = 0; y < static_cast<unsigned int>(tableH); ++y)
-        for (unsigned int x = 0; x < static_cast<unsigned int>(tableW); ++x) {
-            float distToCenter = std::abs((int)tableW/2 - (int)x) / (tableW/2);
-            float edgeShadow = std::min({ y / tableH, (tableH-1-y) / tableH, x / tableW, (tableW-1-x) / tableW });
-            float t = 0.25f*distToCenter + 0.6f*edgeShadow;
-            overlayImg.setPixel(x, y, gradientColor(sf::Color(5,95,45), sf::Color(25, 65, 30), t));
-        }
-    clothOverlay.update(overlayImg);
+    clothOverlay.create(clothParams.width, clothParams.height);
+    clothOverlay.update(clothPixels.data());
 
     sf::Text hud;
     hud.setFont(font);
@@ -143,7 +168,21 @@ int main() {
     hud.setOutlineColor(sf::Color::Black);
     hud.setOutlineThickness(2.f);
 
+    // Frame phase timers; F3 toggles them and the overlay, the session is dumped on exit
+    FrameProfiler profiler;
+    sf::Text profilerText;
+    profilerText.setFont(font);
+    profilerText.setCharacterSize(13);
+    profilerText.setFillColor(sf::Color(250, 250, 250));
+    profilerText.setOutlineColor(sf::Color::Black);
+    profilerText.setOutlineThickness(1.f);
+    profilerText.setPosition(8, 40);
+    sf::Clock profilerRefresh;
+    SimStats profiledStats;
+
+    bool firstFrame = true;
     while (window.isOpen()) {
+        profiler.beginFrame();
         sf::Event event;
         sf::Vector2i mousePix = sf::Mouse::getPosition(window);
         sf::Vector2f mouse = window.mapPixelToCoords(mousePix);
@@ -155,9 +194,9 @@ int main() {
             sf::Vector2f ab = b - a;
             float abLen2 = ab.x * ab.x + ab.y * ab.y;
             float closestT = 1e9f;
-            for (int i = 0; i < balls.size(); ++i) {
-                sf::Vector2f c = balls[i].getPosition();
-                float r = balls[i].getRadius() + hitTolerance;
+            for (int i = 0; i < static_cast<int>(balls.size()); ++i) {
+                sf::Vector2f c = physics->getPosition(i);
+                float r = balls.radius[i] + hitTolerance;
                 sf::Vector2f ac = c - a;
                 float t = (abLen2 > 1e-4f) ? ((ac.x * ab.x + ac.y * ab.y) / abLen2) : 0.f;
                 if (t < 0.f || t > 1.f) continue;
@@ -170,17 +209,58 @@ int main() {
             }
         }
 
+        // Same direction and power the shot would get on release
+        sf::Vector2f aimVec = mouse - dragStart;
+        float aimLen = std::hypot(aimVec.x, aimVec.y);
+        float aimPower = std::clamp(aimLen * 2.f, 0.f, maxPower);
+        if (potentialBall != -1 && aimPower > 20.f) {
+            preview.aim(physics->state(), potentialBall, aimVec.x / aimLen, aimVec.y / aimLen, aimPower);
+            preview.advance(previewBudget);
+        } else {
+            preview.clear();
+        }
+        // Input and the physics step below may pocket or replace balls, so the highlight goes by id
+        std::uint32_t potentialId = potentialBall != -1 ? balls.id[potentialBall] : 0;
+
+        profiler.lap(FramePhase::Picking);
+
         // Input
         while (window.pollEvent(event)) {
             if (event.type == sf::Event::Closed)
                 window.close();
 
             if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::R) {
-                score1 = 0; score2 = 0; player = 1;
-                reset_balls(balls);
+                reset_balls();
+                game.reset(balls.x[0], balls.y[0]);
+                undo.clear();
                 fallingBalls.clear();
-                physics = std::make_unique<PhysicsEngine>(balls, table, pockets);
-                cueBallStartPos = balls[0].getPosition();
+                hintVisible = false;
+            }
+
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F3)
+                profiler.setEnabled(!profiler.enabled());
+
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::U) {
+                TableState state;
+                if (undo.pop(state)) {
+                    // The log can't express a rewind, so restore closes it and starts a new one
+                    physics->restore(state);
+                    game.load(state);
+                    fallingBalls.clear();
+                    showCueAnim = false;
+                    hintVisible = false;
+                }
+            }
+
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::H && !game.shotInProgress()) {
+                ShotSearchParams params;
+                params.budget = std::chrono::milliseconds(12);
+                auto best = solver.search(physics->simulation(), params);
+                hintVisible = !best.empty();
+                if (hintVisible) {
+                    hint = best.front();
+                    hintBall = balls.id[hint.shot.ball];
+                }
             }
 
             if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Left) {
@@ -198,9 +278,9 @@ int main() {
                 sf::Vector2f ab = b - a;
                 float abLen2 = ab.x * ab.x + ab.y * ab.y;
                 float closestT = 1e9f;
-                for (int i = 0; i < balls.size(); ++i) {
-                    sf::Vector2f c = balls[i].getPosition();
-                    float r = balls[i].getRadius() + hitTolerance;
+                for (int i = 0; i < static_cast<int>(balls.size()); ++i) {
+                    sf::Vector2f c = physics->getPosition(i);
+                    float r = balls.radius[i] + hitTolerance;
                     sf::Vector2f ac = c - a;
                     float t = (abLen2 > 1e-4f) ? ((ac.x * ab.x + ac.y * ab.y) / abLen2) : 0.f;
                     if (t < 0.f || t > 1.f) continue;
@@ -219,54 +299,31 @@ int main() {
                     if (power > 20.f) {
                         float len = std::hypot(shotVec.x, shotVec.y);
                         sf::Vector2f dir = (len > 1e-2f) ? shotVec / len : sf::Vector2f{1, 0};
-                        balls[selectedBall].setVelocity(dir * power);
+                        saveState(undo.push());
+                        physics->shoot(selectedBall, dir, power);
 
                         showCueAnim = true;
+                        hintVisible = false;
                         cueAnimTime = 0.f;
-                        ballsMoving = true;
-                        anyScored = false;
-                        cuePocketed = false;
+                        game.beginShot();
                     }
                 }
             }
         }
 
+        profiler.lap(FramePhase::Input);
+
         float dt = clock.restart().asSeconds();
-        physics->update(dt);
-
-        // Check pocketed balls
-        std::vector<int> toErase;
-        for (int i = 0; i < static_cast<int>(balls.size()); ++i) {
-            for (const auto& pocket : pockets) {
-                float dist = std::hypot(balls[i].getPosition().x - pocket.pos.x, balls[i].getPosition().y - pocket.pos.y);
-                if (dist < pocket.radius - balls[i].getRadius() * 0.2f) {
-                    if (balls[i].getNumber() == 0) { // Cue ball in pocket!
-                        cuePocketed = true;
-                        balls[i].setVelocity({0, 0});
-                        break;
-                    } else {
-                        anyScored = true;
-                        if (player == 1) score1++; else score2++;
-                        FallingBall fb{
-                            balls[i].getPosition(),
-                            balls[i].getRadius(),
-                            balls[i].getColor(),
-                            balls[i].getNumber(),
-                            0.f,
-                            &font
-                        };
-                        fallingBalls.push_back({fb, 0.f, 0.6f});
-                        toErase.push_back(i);
-                        break;
-                    }
-                }
-            }
-        }
-        if (!toErase.empty()) {
-            std::sort(toErase.rbegin(), toErase.rend());
-            for (int idx : toErase)
-                balls.erase(balls.begin() + idx);
+        physics->update();
+        profiler.lap(FramePhase::Physics);
+
+        // Pocketed balls: the physics step already took them off the table
+        for (const PocketEvent& e : physics->pocketEvents()) {
+            game.onPocket(e.number);
+            fallingBalls.push_back({FallingBall{{e.x, e.y}, ballRadius, e.number, 0.f}, 0.f, 0.6f});
         }
+        physics->clearPocketEvents();
+        profiler.lap(FramePhase::Pockets);
 
         for (auto& falling : fallingBalls) {
             falling.elapsed += dt;
@@ -279,30 +336,11 @@ int main() {
         );
 
         // Detect all balls stopped
-        if (ballsMoving) {
-            bool allStopped = true;
-            for (const auto& ball : balls)
-                if (std::hypot(ball.getVelocity().x, ball.getVelocity().y) > 1.0f) allStopped = false;
-            if (allStopped) {
-                ballsMoving = false;
-                // Special: Cue ball in pocket?
-                if (cuePocketed) {
-                    // Move cue ball to start
-                    for (auto& ball : balls) {
-                        if (ball.getNumber() == 0) {
-                            ball.setVelocity({0, 0});
-                            ball.move(cueBallStartPos - ball.getPosition());
-                            break;
-                        }
-                    }
-                    player = (player == 1 ? 2 : 1); // Switch turn
-                }
-                // If no ball was pocketed, switch turn
-                else if (!anyScored) {
-                    player = (player == 1 ? 2 : 1);
-                }
-                // else: if pocketed, player keeps the turn (as in Russian billiards)
-            }
+        if (game.shotInProgress() && !physics->isMoving()) {
+            // A scratch or a miss passes the turn; a scratched cue ball goes back to its spot
+            ShotResult result = game.endShot();
+            if (result.respotCue && balls.find(0) == -1)
+                physics->respot(0, {game.cueStartX(), game.cueStartY()}, ballRadius);
         }
 
         if (showCueAnim) {
@@ -313,6 +351,8 @@ int main() {
             }
         }
 
+        profiler.lap(FramePhase::Animation);
+
         // ==== DRAW ====
         window.clear(sf::Color(24, 40, 26));
 
@@ -320,94 +360,38 @@ int main() {
         cloth.setPosition(tableX, tableY);
         window.draw(cloth);
 
-        sf::Color borderColor(90, 45, 20);
-        sf::Color shadowColor(55, 27, 10, 70);
-        std::array<sf::FloatRect, 4> borders = {
-            sf::FloatRect(tableX - borderThickness, tableY - borderThickness, tableW + 2*borderThickness, borderThickness),
-            sf::FloatRect(tableX - borderThickness, tableY + tableH, tableW + 2*borderThickness, borderThickness),
-            sf::FloatRect(tableX - borderThickness, tableY, borderThickness, tableH),
-            sf::FloatRect(tableX + tableW, tableY, borderThickness, tableH)
-        };
-        for (const auto& border : borders) {
-            sf::RectangleShape shadow(sf::Vector2f(border.width, border.height));
-            shadow.setPosition(border.left, border.top + border.height - borderShadow);
-            shadow.setFillColor(shadowColor);
-            window.draw(shadow);
-        }
-        for (const auto& border : borders) {
-            sf::RectangleShape side(sf::Vector2f(border.width, border.height));
-            side.setPosition(border.left, border.top);
-            side.setFillColor(borderColor);
-            side.setOutlineColor(sf::Color(110, 65, 25));
-            side.setOutlineThickness(2.f);
-            window.draw(side);
+        renderer.beginFrame();
+        int highlighted = potentialBall != -1 ? balls.indexOf(potentialId) : BallStore::kNoSlot;
+        if (dragging && highlighted != BallStore::kNoSlot)
+            renderer.addCircle(physics->getPosition(highlighted), balls.radius[highlighted] + 7.f, sf::Color(255, 255, 0, 80));
+        for (std::size_t i = 0; i < balls.size(); ++i)
+            renderer.addShadow({balls.x[i], balls.y[i]}, balls.radius[i]);
+        if (preview.active()) {
+            for (std::size_t k = 0; k < preview.paths().size(); ++k)
+                renderer.addPath(preview.paths()[k].points, 2.f,
+                                 k == 0 ? sf::Color(255, 255, 255, 150) : sf::Color(255, 220, 60, 150));
         }
-
-        for (const auto& pocket : pockets) {
-            sf::CircleShape glow(pocket.radius + 5.f);
-            glow.setOrigin(pocket.radius + 5.f, pocket.radius + 5.f);
-            glow.setPosition(pocket.pos);
-            glow.setFillColor(sf::Color(0, 0, 0, 60));
-            window.draw(glow);
-
-            sf::CircleShape ring(pocket.radius + 2.f);
-            ring.setOrigin(pocket.radius + 2.f, pocket.radius + 2.f);
-            ring.setPosition(pocket.pos);
-            ring.setFillColor(sf::Color(38, 20, 10, 200));
-            window.draw(ring);
-
-            sf::CircleShape dark(pocket.radius);
-            dark.setOrigin(pocket.radius, pocket.radius);
-            dark.setPosition(pocket.pos);
-            dark.setFillColor(sf::Color(10, 10, 10, 255));
-            window.draw(dark);
-        }
-
-        for (int i = 0; i < balls.size(); ++i) {
-            if (i == potentialBall && dragging) {
-                sf::CircleShape glow(balls[i].getRadius() + 7.f);
-                glow.setOrigin(balls[i].getRadius() + 7.f, balls[i].getRadius() + 7.f);
-                glow.setPosition(balls[i].getPosition());
-                glow.setFillColor(sf::Color(255, 255, 0, 80));
-                window.draw(glow);
-            }
-        }
-
-        for (int i = 0; i < balls.size(); ++i) {
-            sf::CircleShape shadow(balls[i].getRadius());
-            shadow.setOrigin(balls[i].getRadius(), balls[i].getRadius());
-            shadow.setPosition(balls[i].getPosition().x + 3.f, balls[i].getPosition().y + 5.f);
-            shadow.setFillColor(sf::Color(25, 30, 20, 80));
-            window.draw(shadow);
-
-            balls[i].draw(window);
+        for (std::size_t i = 0; i < balls.size(); ++i)
+            renderer.addBall({balls.x[i], balls.y[i]}, balls.radius[i], balls.number[i]);
+        for (const auto& falling : fallingBalls) {
+            float scale = 1.f - falling.ball.t;
+            renderer.addBall(falling.ball.pos, falling.ball.radius * scale, falling.ball.number,
+                             static_cast<sf::Uint8>(255 * scale));
         }
 
-        for (const auto& falling : fallingBalls) {
-            float tt = falling.ball.t;
-            float scale = 1.f - tt;
-            float alpha = 255 * (1.f - tt);
-
-            sf::CircleShape circ(falling.ball.radius * scale);
-            circ.setOrigin(falling.ball.radius * scale, falling.ball.radius * scale);
-            circ.setPosition(falling.ball.pos);
-            circ.setFillColor(sf::Color(
-                falling.ball.color.r, falling.ball.color.g, falling.ball.color.b, (sf::Uint8)alpha));
-            circ.setOutlineColor(sf::Color(0,0,0, (sf::Uint8)alpha));
-            circ.setOutlineThickness(2.f * scale);
-            window.draw(circ);
-
-            if (falling.ball.number > 0) {
-                sf::Text numTxt;
-                numTxt.setFont(*falling.ball.font);
-                numTxt.setString(std::to_string(falling.ball.number));
-                numTxt.setCharacterSize(static_cast<unsigned int>(falling.ball.radius * 1.2f * scale));
-                numTxt.setFillColor(sf::Color(0,0,0, (sf::Uint8)alpha));
-                sf::FloatRect bounds = numTxt.getLocalBounds();
-                numTxt.setOrigin(bounds.width/2.f, bounds.height/2.f);
-                numTxt.setPosition(falling.ball.pos);
-                window.draw(numTxt);
-            }
+        // Static borders and pockets, then shadows and ball faces in two batches
+        renderer.drawStatic(window);
+        renderer.drawDynamic(window);
+
+        if (hintVisible && balls.indexOf(hintBall) != BallStore::kNoSlot) {
+            sf::Vector2f from = physics->getPosition(balls.indexOf(hintBall));
+            sf::Vector2f dir(std::cos(hint.shot.angle), std::sin(hint.shot.angle));
+            float len = std::clamp(hint.shot.power * 0.1f, 30.f, 160.f);
+            sf::Vertex line[] = {
+                sf::Vertex(from, sf::Color(255, 255, 0, 200)),
+                sf::Vertex(from + dir * len, sf::Color(255, 255, 0, 0))
+            };
+            window.draw(line, 2, sf::Lines);
         }
 
         if ((dragging || (showCueAnim && selectedBall != -1)) && (dragging || cueAnimTime < cueAnimDuration)) {
@@ -430,53 +414,25 @@ int main() {
                 start = dragStart;
                 end = dragStart + dir * (1.0f - t) * cueLen;
             }
-            sf::RectangleShape cueShadow(sf::Vector2f(cueLen, 6.f));
-            cueShadow.setOrigin(0.f, 3.f);
-            cueShadow.setPosition(start.x + 3.f, start.y + 5.f);
-            cueShadow.setRotation(atan2(end.y - start.y, end.x - start.x) * 180.f / 3.1415926f);
-            cueShadow.setFillColor(sf::Color(25, 30, 20, 60));
-            window.draw(cueShadow);
-            sf::RectangleShape cueStick(sf::Vector2f(cueLen, 6.f));
-            cueStick.setOrigin(0.f, 3.f);
-            cueStick.setPosition(start);
-            cueStick.setRotation(atan2(end.y - start.y, end.x - start.x) * 180.f / 3.1415926f);
-            sf::Color cueColorStart(210, 170, 80);
-            sf::Color cueColorEnd(110, 65, 20);
-            sf::VertexArray gradient(sf::TrianglesStrip, 4);
-            gradient[0].position = sf::Vector2f(0.f, 0.f);
-            gradient[1].position = sf::Vector2f(0.f, 6.f);
-            gradient[2].position = sf::Vector2f(cueLen, 0.f);
-            gradient[3].position = sf::Vector2f(cueLen, 6.f);
-            gradient[0].color = gradient[1].color = cueColorStart;
-            gradient[2].color = gradient[3].color = cueColorEnd;
-            sf::RenderTexture cueTex;
-            cueTex.create(static_cast<unsigned int>(cueLen), 6);
-            cueTex.clear(sf::Color::Transparent);
-            cueTex.draw(gradient);
-            cueTex.display();
-            cueStick.setTexture(&cueTex.getTexture());
-            window.draw(cueStick);
-            sf::RectangleShape tip(sf::Vector2f(11.f, 6.f));
-            tip.setOrigin(11.f, 3.f);
-            tip.setPosition(end);
-            tip.setRotation(atan2(end.y - start.y, end.x - start.x) * 180.f / 3.1415926f);
-            tip.setFillColor(sf::Color(62, 38, 20));
-            window.draw(tip);
+            cue.update(start, end, cueLen, true);
+            cue.draw(window);
         }
 
+        profiler.lap(FramePhase::Draw);
+
         // ==== HUD ====
         hud.setString(
-            "P1: " + std::to_string(score1) + " / " + std::to_string(ballsToWin) +
-            "    P2: " + std::to_string(score2) + " / " + std::to_string(ballsToWin) +
-            "    Turn: P" + std::to_string(player) +
-            "    [R] Restart"
+            "P1: " + std::to_string(game.score(1)) + " / " + std::to_string(game.rules().ballsToWin) +
+            "    P2: " + std::to_string(game.score(2)) + " / " + std::to_string(game.rules().ballsToWin) +
+            "    Turn: P" + std::to_string(game.player()) +
+            "    [R] Restart  [U] Undo  [H] Hint"
         );
         hud.setPosition(windowWidth/2.f - hud.getLocalBounds().width/2.f, 6);
         window.draw(hud);
 
-        if (score1 >= ballsToWin || score2 >= ballsToWin) {
+        if (game.over()) {
             if (!gameJustWon) {
-                winnerPlayer = (score1 >= ballsToWin) ? 1 : 2;
+                winnerPlayer = game.winner();
                 winClock.restart();
                 gameJustWon = true;
             }
@@ -491,11 +447,10 @@ int main() {
 
             // Если прошло 1.5 сек — сбрасываем игру
             if (winClock.getElapsedTime().asSeconds() > 1.5f) {
-                score1 = 0; score2 = 0; player = 1;
-                reset_balls(balls);
+                reset_balls();
+                game.reset(balls.x[0], balls.y[0]);
+                undo.clear();
                 fallingBalls.clear();
-                physics = std::make_unique<PhysicsEngine>(balls, table, pockets);
-                cueBallStartPos = balls[0].getPosition();
                 gameJustWon = false;
                 winnerPlayer = 0;
                 continue; // пропускаем всё остальное, пока ресет
@@ -506,7 +461,42 @@ int main() {
             winnerPlayer = 0;
 }
 
+        if (profiler.enabled()) {
+            // Quarter-second refresh keeps the numbers readable
+            if (profilerRefresh.getElapsedTime().asSeconds() > 0.25f) {
+                // Physics splits a tick into substeps only when a ball is fast enough to tunnel
+                const SimStats& stats = physics->stats();
+                std::uint64_t moving = stats.movingTicks - profiledStats.movingTicks;
+                char line[128];
+                int length = std::snprintf(line, sizeof(line), "substeps  %6.2f /tick moving, %llu ticks\n",
+                                           moving ? double(stats.substeps - profiledStats.substeps) / moving : 0.0,
+                                           static_cast<unsigned long long>(stats.ticks - profiledStats.ticks));
+                if (spectatorPort != 0)
+                    std::snprintf(line + length, sizeof(line) - length, "viewers   %u on port %u\n",
+                                  stats.viewers, static_cast<unsigned>(spectatorPort));
+                profilerText.setString(profiler.overlayText() + line);
+                profiledStats = stats;
+                profilerRefresh.restart();
+            }
+            window.draw(profilerText);
+        }
+        profiler.lap(FramePhase::Hud);
+
         window.display();
+        profiler.lap(FramePhase::Present);
+        profiler.endFrame();
+        if (firstFrame) {
+            profiler.setFirstFrame(startupClock.getElapsedTime().asMicroseconds() / 1000.0);
+            firstFrame = false;
+        }
+    }
+    if (profiler.frames() > 0) {
+        std::filesystem::create_directories("../profiles");
+        char name[64];
+        std::time_t now = std::time(nullptr);
+        std::strftime(name, sizeof(name), "../profiles/frame_%Y%m%d_%H%M%S", std::localtime(&now));
+        profiler.writeCsv(std::string(name) + ".csv");
+        profiler.writeJson(std::string(name) + ".json");
     }
     return 0;
 }
@@ -0,0 +1,206 @@
+// Ролик по записанной партии: физика без окна, кадры в sf::RenderTexture
+// через фиксированное число тиков (не по часам) и запись на диск в фоне (FrameCapture).
+//   reel <game.shotlog> [--out DIR | --out FILE.y4m] [--fps N] [--idle S] [--workers N]
+// По умолчанию — PNG в reels/<имя партии>/. Стол в покое дольше --idle секунд
+// (по умолчанию 0.5) вырезается: остаются только удары. Запускать из корня
+// репозитория: шрифт берётся из assets/, сукно — из cache/.
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "ClothTexture.hpp"
+#include "FrameCapture.hpp"
+#include "ShotLog.hpp"
+#include "TableRenderer.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Как в игре (main.cpp)
+const sf::Color kIvory(232, 229, 203);
+const sf::Color kCueBall(255, 255, 255);
+const sf::Color kBackground(24, 40, 26);
+constexpr float kBorderThickness = 24.f;
+constexpr float kBorderShadow = 8.f;
+constexpr float kFallSeconds = 0.6f;
+
+struct Falling {
+    float x, y, radius;
+    int number;
+    std::uint64_t tick;     // когда упал
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string input, out;
+    unsigned fps = 60, workers = 0;
+    float idleSeconds = 0.5f;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+            out = argv[++i];
+        else if (std::strcmp(argv[i], "--fps") == 0 && i + 1 < argc)
+            fps = static_cast<unsigned>(std::clamp(std::atoi(argv[++i]), 1, 240));
+        else if (std::strcmp(argv[i], "--idle") == 0 && i + 1 < argc)
+            idleSeconds = std::max(0.f, static_cast<float>(std::atof(argv[++i])));
+        else if (std::strcmp(argv[i], "--workers") == 0 && i + 1 < argc)
+            workers = static_cast<unsigned>(std::max(1, std::atoi(argv[++i])));
+        else if (argv[i][0] != '-' && input.empty())
+            input = argv[i];
+        else {
+            input.clear();
+            break;
+        }
+    }
+    if (input.empty()) {
+        std::fprintf(stderr, "usage: reel <game.shotlog> [--out DIR | --out FILE.y4m] [--fps N] [--idle S] [--workers N]\n");
+        return 2;
+    }
+
+    ShotLog log;
+    if (!log.load(input) || log.initial().empty()) {
+        std::fprintf(stderr, "cannot read %s\n", input.c_str());
+        return 1;
+    }
+    if (out.empty())
+        out = (std::filesystem::path("reels") / std::filesystem::path(input).stem()).string();
+
+    // Стол из записи, поля вокруг — как у окна игры
+    const TableGeometry& geometry = log.table();
+    TableLayout layout;
+    layout.x = geometry.left;
+    layout.y = geometry.top;
+    layout.width = geometry.width;
+    layout.height = geometry.height;
+    layout.ballRadius = log.initial().front().radius;
+    if (!geometry.pockets.empty())
+        layout.pocketRadius = geometry.pockets.front().radius;
+    const unsigned width = static_cast<unsigned>(2 * geometry.left + geometry.width) & ~1u;
+    const unsigned height = static_cast<unsigned>(2 * geometry.top + geometry.height) & ~1u;
+
+    sf::Font font;
+    if (!font.loadFromFile("assets/SEGUISB.TTF")) {
+        std::fprintf(stderr, "cannot load assets/SEGUISB.TTF\n");
+        return 1;
+    }
+    int maxNumber = 0;
+    for (const BallState& b : log.initial())
+        maxNumber = std::max(maxNumber, b.number);
+    std::vector<Ball> looks;
+    looks.emplace_back(layout.ballRadius, kCueBall, 0, &font);
+    for (int k = 1; k <= maxNumber; ++k)
+        looks.emplace_back(layout.ballRadius, kIvory, k, &font);
+    BallAtlas atlas(looks);
+    TableRenderer renderer(layout, atlas, kBorderThickness, kBorderShadow);
+
+    ClothParams clothParams;
+    clothParams.width = static_cast<unsigned>(layout.width);
+    clothParams.height = static_cast<unsigned>(layout.height);
+    std::vector<std::uint8_t> clothPixels = loadOrGenerateCloth("cache", clothParams);
+    sf::Texture cloth;
+    cloth.create(clothParams.width, clothParams.height);
+    cloth.update(clothPixels.data());
+
+    sf::RenderTexture target;
+    if (!target.create(width, height)) {
+        std::fprintf(stderr, "cannot create a %ux%u render texture\n", width, height);
+        return 1;
+    }
+
+    FrameCapture::Options options;
+    options.format = out.size() > 4 && out.compare(out.size() - 4, 4, ".y4m") == 0 ? FrameCapture::Format::Y4m
+                                                                                    : FrameCapture::Format::Png;
+    options.path = out;
+    options.width = width;
+    options.height = height;
+    options.fps = fps;
+    options.workers = workers;
+    FrameCapture capture(options);
+    if (!capture.ok()) {
+        std::fprintf(stderr, "%s\n", capture.error().c_str());
+        return 1;
+    }
+
+    // Кадр — каждые 240/fps тиков физики; время стола, а не часов
+    const double ticksPerFrame = 1.0 / (Simulation::kFixedDt * fps);
+    const std::uint64_t idleTicks = static_cast<std::uint64_t>(idleSeconds / Simulation::kFixedDt);
+    const std::uint64_t fallTicks = static_cast<std::uint64_t>(kFallSeconds / Simulation::kFixedDt);
+    double nextFrame = 0.0;
+    std::uint64_t restTicks = 0, simTicks = 0;
+    std::size_t seenPockets = 0;
+    std::vector<Falling> falling;
+    double renderSeconds = 0.0;
+    auto t0 = Clock::now();
+
+    ReplayResult result = log.replay([&](const Simulation& sim) {
+        const std::uint64_t tick = sim.tick();
+        simTicks = tick;
+        for (; seenPockets < sim.pocketEvents().size(); ++seenPockets) {
+            const PocketEvent& e = sim.pocketEvents()[seenPockets];
+            falling.push_back({e.x, e.y, layout.ballRadius, e.number, tick});
+        }
+        falling.erase(std::remove_if(falling.begin(), falling.end(),
+                                     [&](const Falling& f) { return tick - f.tick >= fallTicks; }),
+                      falling.end());
+
+        // Долгий покой вырезается: расписание кадров просто сдвигается
+        restTicks = sim.isAtRest() && falling.empty() ? restTicks + 1 : 0;
+        if (restTicks > idleTicks) {
+            nextFrame = std::max(nextFrame, static_cast<double>(tick));
+            return;
+        }
+        if (tick < nextFrame)
+            return;
+        nextFrame += ticksPerFrame;
+
+        auto r0 = Clock::now();
+        const BallStore& balls = sim.balls();
+        target.clear(kBackground);
+        sf::Sprite clothSprite(cloth);
+        clothSprite.setPosition(layout.x, layout.y);
+        target.draw(clothSprite);
+        renderer.beginFrame();
+        for (std::size_t i = 0; i < balls.size(); ++i)
+            renderer.addShadow({balls.x[i], balls.y[i]}, balls.radius[i]);
+        for (std::size_t i = 0; i < balls.size(); ++i)
+            renderer.addBall({balls.x[i], balls.y[i]}, balls.radius[i], balls.number[i]);
+        for (const Falling& f : falling) {
+            float scale = 1.f - static_cast<float>(tick - f.tick) / fallTicks;
+            renderer.addBall({f.x, f.y}, f.radius * scale, f.number, static_cast<sf::Uint8>(255 * scale));
+        }
+        renderer.drawStatic(target);
+        renderer.drawDynamic(target);
+        target.display();
+
+        // Чтение из видеопамяти — единственное, что ждёт рендер; кодирует и пишет пул
+        sf::Image frame = target.getTexture().copyToImage();
+        renderSeconds += std::chrono::duration<double>(Clock::now() - r0).count();
+        capture.push(frame.getPixelsPtr());
+    });
+    const double renderLoop = std::chrono::duration<double>(Clock::now() - t0).count();
+    const bool written = capture.finish();
+    const double total = std::chrono::duration<double>(Clock::now() - t0).count();
+
+    if (!result.ok)
+        std::fprintf(stderr, "warning: %s diverged at tick %llu; the reel stops there\n", input.c_str(),
+                     static_cast<unsigned long long>(result.failedTick));
+    if (!written) {
+        std::fprintf(stderr, "%s\n", capture.error().c_str());
+        return 1;
+    }
+    const std::uint64_t frames = capture.frames();
+    std::printf("%llu frames (%.1f s of video at %u fps) from %.1f s of play -> %s\n",
+                static_cast<unsigned long long>(frames), double(frames) / fps, fps,
+                simTicks * Simulation::kFixedDt, out.c_str());
+    std::printf("render %.2f ms/frame, render loop %.2f s, stalled on encoders %.2f s, total %.2f s "
+                "(%.1fx real time, %u encoder threads)\n",
+                frames ? 1e3 * renderSeconds / frames : 0.0, renderLoop, capture.stallSeconds(), total,
+                total > 0 ? (double(frames) / fps) / total : 0.0, capture.workers());
+    return 0;
+}
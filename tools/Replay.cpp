@@ -0,0 +1,127 @@
+// Воспроизведение записанных партий без окна, на полной скорости.
+//   replay <file.shotlog | dir>...          сверить все записи, код 1 при расхождении
+//   replay --synth <count> <dir> [seed]     записать случайные партии для регрессии
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+#include "ShotLog.hpp"
+#include "TableLayout.hpp"
+#include "WorkStealingPool.hpp"
+
+namespace fs = std::filesystem;
+
+// Партия по правилам main.cpp: кадр = 4 тика, события луз разбираются после
+// кадра, биток из лузы возвращается на место, когда всё остановилось
+static ShotLog synthGame(unsigned seed) {
+    TableLayout layout;
+    Simulation sim(layout.geometry());
+    layout.rack(sim.balls());
+    BallStore& balls = sim.balls();
+    const BallState cueStart = balls.get(0);
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> angle(0.f, 6.2831853f), power(300.f, 1600.f);
+    ShotLog log;
+    log.begin(sim);
+
+    for (int shot = 0; shot < 40 && balls.size() > 2; ++shot) {
+        std::uniform_int_distribution<int> pick(0, static_cast<int>(balls.size()) - 1);
+        int ball = pick(rng);
+        float a = angle(rng), p = power(rng);
+        log.shot(sim, ball, std::cos(a), std::sin(a), p);
+        balls.setVelocity(ball, std::cos(a) * p, std::sin(a) * p);
+
+        bool cuePocketed = false;
+        for (int frame = 0; frame < 60 * 120 && !sim.isAtRest(); ++frame) {
+            for (int s = 0; s < 4; ++s)
+                sim.step();
+            for (const auto& e : sim.pocketEvents())
+                cuePocketed |= e.number == 0;
+            sim.clearPocketEvents();
+            log.frame(sim);
+        }
+        if (cuePocketed && balls.find(0) < 0) {
+            balls.push(cueStart);
+            log.place(sim, 0);
+        }
+    }
+    log.finish(sim);
+    return log;
+}
+
+static int synth(int count, const std::string& dir, unsigned seed) {
+    fs::create_directories(dir);
+    for (int g = 0; g < count; ++g) {
+        ShotLog log = synthGame(seed + g);
+        char name[32];
+        std::snprintf(name, sizeof(name), "synth_%05d.shotlog", g);
+        if (!log.save((fs::path(dir) / name).string())) {
+            std::fprintf(stderr, "cannot write %s\n", name);
+            return 1;
+        }
+    }
+    std::printf("wrote %d games to %s\n", count, dir.c_str());
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 4 && std::strcmp(argv[1], "--synth") == 0)
+        return synth(std::atoi(argv[2]), argv[3], argc >= 5 ? static_cast<unsigned>(std::atoi(argv[4])) : 1u);
+
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        if (fs::is_directory(argv[i])) {
+            for (const auto& entry : fs::directory_iterator(argv[i]))
+                if (entry.path().extension() == ".shotlog")
+                    files.push_back(entry.path().string());
+        } else {
+            files.push_back(argv[i]);
+        }
+    }
+    if (files.empty()) {
+        std::fprintf(stderr, "usage: replay <file.shotlog | dir>...\n"
+                             "       replay --synth <count> <dir> [seed]\n");
+        return 2;
+    }
+
+    std::vector<ReplayResult> results(files.size());
+    std::vector<char> loaded(files.size(), 0);
+    WorkStealingPool pool;
+    auto t0 = std::chrono::steady_clock::now();
+    pool.parallelFor(files.size(), [&](std::size_t i, unsigned) {
+        ShotLog log;
+        if (log.load(files[i])) {
+            loaded[i] = 1;
+            results[i] = log.replay();
+        }
+    });
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::uint64_t ticks = 0;
+    std::size_t checksums = 0, failed = 0;
+    for (std::size_t i = 0; i < files.size(); ++i) {
+        if (!loaded[i]) {
+            std::printf("UNREADABLE %s\n", files[i].c_str());
+            ++failed;
+            continue;
+        }
+        ticks += results[i].ticks;
+        checksums += results[i].checksums;
+        if (!results[i].ok) {
+            std::printf("DIVERGED   %s at tick %llu\n", files[i].c_str(),
+                        static_cast<unsigned long long>(results[i].failedTick));
+            ++failed;
+        }
+    }
+    std::printf("%zu games, %llu ticks, %zu checksums, %zu failed, %.2f s (%.0f games/s, %.1fx real time)\n",
+                files.size(), static_cast<unsigned long long>(ticks), checksums, failed, sec,
+                files.size() / sec, ticks * Simulation::kFixedDt / sec);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,115 @@
+// Построение таблицы вероятностей срезов (ShotTable) для стандартного стола.
+//   shot_table [out.bin] [--trials N] [--check N] [--profile NAME]
+// По умолчанию пишет cache/shot_table.bin. --check N сравнивает ответы
+// таблицы с живой EventSimulation на N случайных ударах.
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "EventSimulation.hpp"
+#include "ShotTable.hpp"
+
+namespace {
+
+// Случайные два шара на столе и удар с точным прицелом в «призрачный шар»:
+// таблица против одного прогона, средняя ошибка и точность порога 0.5
+void check(const TableLayout& layout, const PhysicsParams& params, const ShotTable& table, int count) {
+    const TableGeometry geometry = layout.geometry();
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> ux(layout.x + 2 * layout.ballRadius, layout.x + layout.width - 2 * layout.ballRadius);
+    std::uniform_real_distribution<float> uy(layout.y + 2 * layout.ballRadius, layout.y + layout.height - 2 * layout.ballRadius);
+    std::uniform_real_distribution<float> power(300.f, 1600.f);
+    std::uniform_int_distribution<int> pocketPick(0, static_cast<int>(geometry.pockets.size()) - 1);
+
+    std::vector<ShotQuery> queries;
+    std::vector<char> hits;
+    while (static_cast<int>(queries.size()) < count) {
+        BallStore balls;
+        balls.push({ux(rng), uy(rng), 0.f, 0.f, layout.ballRadius, 0});
+        balls.push({ux(rng), uy(rng), 0.f, 0.f, layout.ballRadius, 1});
+        int pocket = pocketPick(rng);
+        float p = power(rng);
+        ShotQuery q = ShotTable::describe(geometry, balls, 0, 1, pocket, p);
+        if (std::hypot(balls.x[0] - balls.x[1], balls.y[0] - balls.y[1]) < 3 * layout.ballRadius ||
+            std::fabs(q.cut) > 1.2f)
+            continue;
+
+        const PocketState& k = geometry.pockets[pocket];
+        float ox = balls.x[1] - k.x, oy = balls.y[1] - k.y;
+        float d = std::hypot(ox, oy);
+        float gx = balls.x[1] + ox / d * 2 * layout.ballRadius, gy = balls.y[1] + oy / d * 2 * layout.ballRadius;
+        float ax = gx - balls.x[0], ay = gy - balls.y[0];
+        float a = std::hypot(ax, ay);
+        balls.setVelocity(0, ax / a * p, ay / a * p);
+        EventSimulation events(geometry, balls, params);
+        events.simulateUntilRest();
+        bool hit = false;
+        for (int n : events.pocketed())
+            hit |= n == 1;
+
+        queries.push_back(q);
+        hits.push_back(hit);
+    }
+
+    std::vector<float> predicted(queries.size());
+    auto t0 = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < queries.size(); ++i)
+        predicted[i] = table.probability(queries[i]);
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+
+    int agree = 0, potted = 0;
+    double brier = 0.0;
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+        brier += (predicted[i] - hits[i]) * (predicted[i] - hits[i]);
+        agree += (predicted[i] >= 0.5f) == static_cast<bool>(hits[i]);
+        potted += hits[i];
+    }
+    std::printf("check: %d shots (%.1f%% potted), Brier %.3f, %.1f%% agree at 0.5, %.0f ns per lookup\n",
+                count, 100.0 * potted / count, brier / count, 100.0 * agree / count, ns / count);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string out = "cache/shot_table.bin";
+    ShotTable::Grid grid;
+    int checks = 0;
+    const PhysicsProfileInfo* profile = &physicsProfiles().front();
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--trials") == 0 && i + 1 < argc)
+            grid.trials = static_cast<std::uint32_t>(std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--check") == 0 && i + 1 < argc)
+            checks = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--profile") == 0 && i + 1 < argc && findPhysicsProfile(argv[i + 1]))
+            profile = findPhysicsProfile(argv[++i]);
+        else if (argv[i][0] != '-')
+            out = argv[i];
+        else {
+            std::fprintf(stderr, "usage: shot_table [out.bin] [--trials N] [--check N] [--profile NAME]\n");
+            return 2;
+        }
+    }
+
+    TableLayout layout;
+    WorkStealingPool pool;
+    auto t0 = std::chrono::steady_clock::now();
+    if (!ShotTable::build(layout, grid, pool, out, profile->params)) {
+        std::fprintf(stderr, "cannot write %s\n", out.c_str());
+        return 1;
+    }
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    ShotTable table;
+    if (!table.open(out, layout, profile->params)) {
+        std::fprintf(stderr, "%s\n", table.error().c_str());
+        return 1;
+    }
+    std::printf("wrote %s (%s) in %.1f s on %u threads\n", out.c_str(), profile->name, sec, pool.size());
+    if (checks > 0)
+        check(layout, profile->params, table, checks);
+    return 0;
+}
@@ -0,0 +1,265 @@
+// Зритель трансляции стола (SpectatorServer) без окна.
+//   spectator --port P                 смотреть игру (app --spectate P), раз в секунду — сводка
+//   spectator --check [--seconds S] [--viewers N] [--speed X]
+// --check поднимает сервер и физику в одном процессе: случайные удары
+// в X раз быстрее реального времени, N зрителей читают сразу, ещё один —
+// медленно, чтобы сервер сбрасывал ему очередь. Каждый восстановленный стол
+// сверяется с настоящим на том же тике; код возврата 1 при расхождении.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+#include "SpectatorServer.hpp"
+#include "TableLayout.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Стол, который восстановил зритель, на тике после очередной порции байт
+struct Seen {
+    std::uint64_t tick;
+    std::vector<SpectatorBall> balls;
+};
+
+struct ViewerRun {
+    bool slow = false;
+    bool connected = false;
+    bool broken = false;            // поток не разобрался
+    std::uint64_t bytes = 0;
+    SpectatorDecoder decoder;
+    std::vector<Seen> seen;
+};
+
+// Медленный зритель с маленьким буфером читает 256 байт раз в 50 мс —
+// меньше, чем шлёт сервер
+void watch(std::uint16_t port, ViewerRun& run, const std::atomic<bool>& stop) {
+    TcpSocket socket = TcpSocket::connect(port);
+    run.connected = socket.valid();
+    if (run.slow)
+        socket.setBuffers(0, 4096);
+    std::vector<std::uint8_t> buffer(run.slow ? 256 : 64 * 1024);
+    std::vector<SocketWait> wait(1);
+    wait[0].socket = &socket;
+    wait[0].read = true;
+    while (socket.valid() && !stop.load(std::memory_order_relaxed)) {
+        if (run.slow)
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        else
+            waitSockets(wait, 10);
+        long n = socket.recv(buffer.data(), buffer.size());
+        if (n < 0)
+            break;
+        if (n == 0)
+            continue;
+        run.bytes += static_cast<std::uint64_t>(n);
+        if (!run.decoder.feed(buffer.data(), static_cast<std::size_t>(n))) {
+            run.broken = true;
+            break;
+        }
+        if (run.decoder.synced() && (run.seen.empty() || run.seen.back().tick != run.decoder.tick()))
+            run.seen.push_back({run.decoder.tick(), run.decoder.balls()});
+    }
+}
+
+// Биток в случайный шар; забитый биток возвращается на стол, почти пустой
+// стол расставляется заново — трансляция видит и новые шары, и смену стола
+void strike(Simulation& sim, const TableLayout& layout, std::mt19937& rng) {
+    BallStore& balls = sim.balls();
+    if (balls.size() < 4) {
+        layout.rack(balls);
+        return;
+    }
+    if (balls.find(0) < 0)
+        balls.push({layout.x + layout.width / 4, layout.y + layout.height / 2, 0.f, 0.f, layout.ballRadius, 0});
+    int cue = balls.find(0);
+    std::uniform_int_distribution<int> pick(0, static_cast<int>(balls.size()) - 1);
+    std::uniform_real_distribution<float> spread(-0.05f, 0.05f), power(600.f, 1600.f);
+    int target = pick(rng);
+    if (target == cue)
+        target = (target + 1) % static_cast<int>(balls.size());
+    float a = std::atan2(balls.y[target] - balls.y[cue], balls.x[target] - balls.x[cue]) + spread(rng);
+    float p = power(rng);
+    balls.setVelocity(cue, std::cos(a) * p, std::sin(a) * p);
+}
+
+int check(int seconds, int viewerCount, double speed) {
+    TableLayout layout;
+    Simulation sim(layout.geometry());
+    layout.rack(sim.balls());
+    SpectatorServer server(0);
+    if (!server.listening()) {
+        std::fprintf(stderr, "cannot listen on 127.0.0.1\n");
+        return 1;
+    }
+
+    std::atomic<bool> stop{false};
+    std::vector<ViewerRun> runs(static_cast<std::size_t>(viewerCount) + 1);
+    runs.back().slow = true;
+    std::vector<std::thread> threads;
+    for (ViewerRun& run : runs)
+        threads.emplace_back(watch, server.port(), std::ref(run), std::cref(stop));
+    auto deadline = Clock::now() + std::chrono::seconds(2);
+    while (server.viewers() < runs.size() && Clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    // Настоящий стол на каждом тике, с которого начинается трансляция
+    const std::uint64_t firstTick = sim.tick();
+    const int ticks = static_cast<int>(seconds / Simulation::kFixedDt);
+    std::vector<std::vector<SpectatorBall>> truth;
+    truth.reserve(static_cast<std::size_t>(ticks) + 1);
+    std::mt19937 rng(5);
+    double publishMax = 0.0, publishSum = 0.0;
+    std::uint64_t pocketed = 0;
+    const auto period = std::chrono::duration<double>(Simulation::kFixedDt / speed);
+    auto next = Clock::now();
+
+    for (int t = 0; t <= ticks; ++t) {
+        if (t > 0) {
+            if (sim.isAtRest())
+                strike(sim, layout, rng);
+            sim.step();
+        }
+        auto t0 = Clock::now();
+        server.publish(sim);
+        double us = std::chrono::duration<double, std::micro>(Clock::now() - t0).count();
+        publishMax = std::max(publishMax, us);
+        publishSum += us;
+        pocketed += sim.pocketEvents().size();
+        sim.clearPocketEvents();
+
+        const BallStore& balls = sim.balls();
+        std::vector<SpectatorBall> state;
+        for (std::size_t i = 0; i < balls.size(); ++i)
+            state.push_back({balls.id[i], balls.number[i], balls.x[i], balls.y[i], balls.radius[i]});
+        truth.push_back(std::move(state));
+
+        next += std::chrono::duration_cast<Clock::duration>(period);
+        std::this_thread::sleep_until(next);
+    }
+    // Дать сети дослать хвост
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    stop.store(true);
+    for (std::thread& t : threads)
+        t.join();
+
+    // Зритель видит кванты 1/kScale px: ошибка не больше половины кванта
+    const float tolerance = 0.5f / SpectatorEncoder::kScale + 1e-3f;
+    int failures = 0;
+    std::printf("%d ticks at %.1fx, %llu balls pocketed; publish %.2f us avg, %.1f us max\n", ticks, speed,
+                static_cast<unsigned long long>(pocketed), publishSum / (ticks + 1), publishMax);
+    std::printf("server: %llu frames sent, %llu dropped, %.1f bytes/tick to each viewer\n",
+                static_cast<unsigned long long>(server.framesSent()),
+                static_cast<unsigned long long>(server.framesDropped()),
+                runs.empty() ? 0.0 : double(runs.front().bytes) / (ticks + 1));
+    std::printf("%-8s %8s %6s %8s %8s %10s %9s %6s\n", "viewer", "frames", "keys", "skipped", "checked",
+                "checksums", "max err", "ok");
+    for (std::size_t v = 0; v < runs.size(); ++v) {
+        const ViewerRun& run = runs[v];
+        float maxError = 0.f;
+        bool ok = run.connected && !run.broken && !run.seen.empty() && run.decoder.mismatches() == 0;
+        for (const Seen& s : run.seen) {
+            if (s.tick < firstTick || s.tick - firstTick >= truth.size()) {
+                ok = false;
+                break;
+            }
+            const std::vector<SpectatorBall>& real = truth[s.tick - firstTick];
+            ok = ok && real.size() == s.balls.size();
+            for (const SpectatorBall& b : s.balls) {
+                auto it = std::find_if(real.begin(), real.end(), [&](const SpectatorBall& r) { return r.id == b.id; });
+                if (it == real.end() || it->number != b.number) {
+                    ok = false;
+                    continue;
+                }
+                maxError = std::max({maxError, std::fabs(it->x - b.x), std::fabs(it->y - b.y)});
+            }
+        }
+        ok = ok && maxError <= tolerance;
+        // Быстрые зрители не должны терять кадры
+        ok = ok && (run.slow || run.decoder.skipped() == 0);
+        failures += !ok;
+        std::printf("%-8s %8llu %6llu %8llu %8zu %10llu %9.4f %6s\n", run.slow ? "slow" : "fast",
+                    static_cast<unsigned long long>(run.decoder.frames()),
+                    static_cast<unsigned long long>(run.decoder.keyframes()),
+                    static_cast<unsigned long long>(run.decoder.skipped()), run.seen.size(),
+                    static_cast<unsigned long long>(run.decoder.mismatches()), maxError, ok ? "yes" : "NO");
+    }
+    return failures ? 1 : 0;
+}
+
+int spectate(std::uint16_t port) {
+    TcpSocket socket = TcpSocket::connect(port);
+    if (!socket.valid()) {
+        std::fprintf(stderr, "nothing is streaming on 127.0.0.1:%u\n", static_cast<unsigned>(port));
+        return 1;
+    }
+    SpectatorDecoder decoder;
+    std::vector<std::uint8_t> buffer(64 * 1024);
+    std::vector<SocketWait> wait(1);
+    wait[0].socket = &socket;
+    wait[0].read = true;
+    std::uint64_t bytes = 0;
+    auto report = Clock::now() + std::chrono::seconds(1);
+    for (;;) {
+        waitSockets(wait, 100);
+        long n = socket.recv(buffer.data(), buffer.size());
+        if (n < 0)
+            break;
+        bytes += static_cast<std::uint64_t>(n);
+        if (n > 0 && !decoder.feed(buffer.data(), static_cast<std::size_t>(n))) {
+            std::fprintf(stderr, "corrupt stream\n");
+            return 1;
+        }
+        if (Clock::now() >= report) {
+            std::printf("tick %llu: %zu balls, %llu pocketed, %llu frames (%llu key), %llu checksum errors, %llu B/s\n",
+                        static_cast<unsigned long long>(decoder.tick()), decoder.balls().size(),
+                        static_cast<unsigned long long>(decoder.pocketed()),
+                        static_cast<unsigned long long>(decoder.frames()),
+                        static_cast<unsigned long long>(decoder.keyframes()),
+                        static_cast<unsigned long long>(decoder.mismatches()),
+                        static_cast<unsigned long long>(bytes));
+            std::fflush(stdout);
+            bytes = 0;
+            report += std::chrono::seconds(1);
+        }
+    }
+    std::printf("stream closed\n");
+    return decoder.mismatches() ? 1 : 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int port = 0, seconds = 30, viewers = 2;
+    double speed = 8.0;
+    bool runCheck = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--port") == 0 && i + 1 < argc)
+            port = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--check") == 0)
+            runCheck = true;
+        else if (std::strcmp(argv[i], "--seconds") == 0 && i + 1 < argc)
+            seconds = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--viewers") == 0 && i + 1 < argc)
+            viewers = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--speed") == 0 && i + 1 < argc)
+            speed = std::max(0.1, std::atof(argv[++i]));
+        else {
+            std::fprintf(stderr, "usage: spectator --port P | --check [--seconds S] [--viewers N] [--speed X]\n");
+            return 2;
+        }
+    }
+    if (runCheck)
+        return check(seconds, viewers, speed);
+    if (port <= 0 || port > 65535) {
+        std::fprintf(stderr, "usage: spectator --port P | --check [--seconds S] [--viewers N] [--speed X]\n");
+        return 2;
+    }
+    return spectate(static_cast<std::uint16_t>(port));
+}
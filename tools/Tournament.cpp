@@ -0,0 +1,370 @@
+// Турнир без окна: полные партии между стратегиями удара на всех ядрах.
+// Цифры идут на подбор параметров стола, главная — партий в секунду на ядро.
+//   tournament [--games N] [--threads T] [--p1 NAME] [--p2 NAME] [--seed S]
+//              [--max-shots N] [--events] [--table FILE] [--profile NAME]
+// Стратегии: random, ghost, greedy, table (нужна --table, см. shot_table). Разбивают по очереди: чётные партии — p1,
+// нечётные — p2. --events считает удары EventSimulation вместо шагов.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "EventSimulation.hpp"
+#include "GameRules.hpp"
+#include "ShotSolver.hpp"
+#include "ShotTable.hpp"
+#include "TableLayout.hpp"
+#include "WorkStealingPool.hpp"
+
+namespace {
+
+// Что видит стратегия перед ударом
+struct Turn {
+    const Simulation& table;
+    Simulation& scratch;    // копия стола для пробных ударов
+    std::mt19937& rng;
+    bool exact;
+    const ShotTable& odds;
+};
+
+using Policy = Shot (*)(Turn& turn);
+
+// Любой шар, случайные угол и сила — как --synth у replay
+Shot randomShot(Turn& turn) {
+    std::uniform_int_distribution<int> pick(0, static_cast<int>(turn.table.balls().size()) - 1);
+    std::uniform_real_distribution<float> angle(0.f, 6.2831853f), power(300.f, 1600.f);
+    int ball = pick(turn.rng);
+    float a = angle(turn.rng);
+    return {ball, a, power(turn.rng)};
+}
+
+// Удары битком в точку «призрачного шара» для каждой пары (шар, луза),
+// от простых к сложным: короче путь и меньше срез — выше в списке.
+// Загораживающие шары не проверяются
+std::vector<Shot> ghostShots(const Simulation& table) {
+    struct Candidate {
+        Shot shot;
+        float cost;
+    };
+    const BallStore& balls = table.balls();
+    int cue = balls.find(0);
+    std::vector<Candidate> found;
+    if (cue < 0)
+        return {};
+
+    for (std::size_t o = 0; o < balls.size(); ++o) {
+        if (static_cast<int>(o) == cue)
+            continue;
+        for (const PocketState& p : table.table().pockets) {
+            float dx = p.x - balls.x[o], dy = p.y - balls.y[o];
+            float d = std::sqrt(dx * dx + dy * dy);
+            if (d < 1e-3f)
+                continue;
+            float reach = balls.radius[o] + balls.radius[cue];
+            float gx = balls.x[o] - dx / d * reach;
+            float gy = balls.y[o] - dy / d * reach;
+            float ax = gx - balls.x[cue], ay = gy - balls.y[cue];
+            float a = std::sqrt(ax * ax + ay * ay);
+            if (a < 1e-3f)
+                continue;
+            // Срез круче ~75° не проходит
+            float cut = (ax * dx + ay * dy) / (a * d);
+            if (cut < 0.25f)
+                continue;
+            float power = std::clamp(300.f + 1.2f * (a + d / cut), 300.f, 1600.f);
+            found.push_back({{cue, std::atan2(ay, ax), power}, (a + d) / cut});
+        }
+    }
+    std::sort(found.begin(), found.end(),
+              [](const Candidate& l, const Candidate& r) { return l.cost < r.cost; });
+    std::vector<Shot> shots;
+    for (const Candidate& c : found)
+        shots.push_back(c.shot);
+    return shots;
+}
+
+Shot ghostShot(Turn& turn) {
+    std::vector<Shot> shots = ghostShots(turn.table);
+    return shots.empty() ? randomShot(turn) : shots.front();
+}
+
+// Лучшие кандидаты «призрака» на нескольких силах, каждый прогнан до остановки.
+// Перебор внутри партии последовательный: партии и так занимают все ядра
+Shot greedyShot(Turn& turn) {
+    static constexpr std::size_t kCandidates = 6;
+    static constexpr float kPowerScale[] = {0.7f, 1.f, 1.4f};
+
+    std::vector<Shot> shots = ghostShots(turn.table);
+    if (shots.empty())
+        return randomShot(turn);
+    shots.resize(std::min(shots.size(), kCandidates));
+
+    // Стол больше снимка — кандидат начинает с полной копии, как в ShotSolver
+    TableState base;
+    const bool flat = base.capture(turn.table.balls());
+    Shot best = shots.front();
+    float bestScore = 0.f;
+    for (const Shot& s : shots)
+        for (float k : kPowerScale) {
+            Shot trial{s.ball, s.angle, std::min(s.power * k, 1600.f)};
+            if (flat) {
+                base.restore(turn.scratch.balls());
+                turn.scratch.resetContacts();
+            } else {
+                turn.scratch = turn.table;
+            }
+            ShotOutcome out = ShotSolver::evaluate(turn.scratch, trial, turn.exact);
+            if (out.score > bestScore) {
+                bestScore = out.score;
+                best = trial;
+            }
+        }
+    return best;
+}
+
+// Самый вероятный срез по таблице: все пары (шар, луза) на нескольких силах,
+// без единого прогона физики
+Shot tableShot(Turn& turn) {
+    static constexpr float kPowers[] = {500.f, 900.f, 1300.f};
+
+    const BallStore& balls = turn.table.balls();
+    const TableGeometry& geometry = turn.table.table();
+    int cue = balls.find(0);
+    if (cue < 0)
+        return randomShot(turn);
+    Shot best{};
+    float bestOdds = -1.f;
+    for (std::size_t o = 0; o < balls.size(); ++o) {
+        if (static_cast<int>(o) == cue)
+            continue;
+        for (std::size_t p = 0; p < geometry.pockets.size(); ++p) {
+            ShotQuery q = ShotTable::describe(geometry, balls, cue, static_cast<int>(o), static_cast<int>(p), 0.f);
+            if (std::fabs(q.cut) > 1.3f)
+                continue;
+            for (float power : kPowers) {
+                q.power = power;
+                float odds = turn.odds.probability(q);
+                if (odds > bestOdds) {
+                    // Направление — в точку «призрачного шара»
+                    const PocketState& k = geometry.pockets[p];
+                    float dx = balls.x[o] - k.x, dy = balls.y[o] - k.y;
+                    float reach = (balls.radius[o] + balls.radius[cue]) / q.pocketDistance;
+                    float gx = balls.x[o] + dx * reach, gy = balls.y[o] + dy * reach;
+                    best = {cue, std::atan2(gy - balls.y[cue], gx - balls.x[cue]), power};
+                    bestOdds = odds;
+                }
+            }
+        }
+    }
+    return bestOdds < 0.f ? ghostShot(turn) : best;
+}
+
+struct PolicyEntry {
+    const char* name;
+    Policy choose;
+};
+
+const PolicyEntry kPolicies[] = {
+    {"random", randomShot},
+    {"ghost", ghostShot},
+    {"greedy", greedyShot},
+    {"table", tableShot},
+};
+
+const PolicyEntry* findPolicy(const char* name) {
+    for (const PolicyEntry& p : kPolicies)
+        if (std::strcmp(p.name, name) == 0)
+            return &p;
+    return nullptr;
+}
+
+struct Options {
+    std::size_t games = 1000;
+    unsigned threads = 0;   // 0 — все ядра
+    const PolicyEntry* p1 = &kPolicies[1];
+    const PolicyEntry* p2 = &kPolicies[0];
+    unsigned seed = 1;
+    int maxShots = 300;
+    bool exact = false;
+    std::string table;
+    const PhysicsProfileInfo* profile = &physicsProfiles().front();
+};
+
+// Счётчики одного потока; своя линия кэша, чтобы потоки не толкались
+struct alignas(64) Tally {
+    std::uint64_t games = 0;
+    std::uint64_t wins[2] = {0, 0};     // по стратегиям: p1, p2
+    std::uint64_t draws = 0;
+    std::uint64_t shots = 0;
+    std::uint64_t scratches = 0;
+    std::uint64_t breakBalls = 0;
+    std::uint64_t breaksScored = 0;
+    std::uint64_t breakScratches = 0;
+
+    void add(const Tally& t) {
+        games += t.games;
+        wins[0] += t.wins[0];
+        wins[1] += t.wins[1];
+        draws += t.draws;
+        shots += t.shots;
+        scratches += t.scratches;
+        breakBalls += t.breakBalls;
+        breaksScored += t.breaksScored;
+        breakScratches += t.breakScratches;
+    }
+};
+
+// Одна партия по GameRules. Стороны: seat[0] — игрок 1 (разбивает)
+void playGame(const TableLayout& layout, const Options& opt, const ShotTable& odds, std::size_t index,
+              Simulation& sim, Simulation& scratch, Tally& tally) {
+    std::seed_seq seq{opt.seed, static_cast<unsigned>(index), static_cast<unsigned>(index >> 32)};
+    std::mt19937 rng(seq);
+    const bool swapped = index & 1;
+    const PolicyEntry* seat[2] = {swapped ? opt.p2 : opt.p1, swapped ? opt.p1 : opt.p2};
+
+    BallStore& balls = sim.balls();
+    layout.rack(balls);
+    const BallState cueStart = balls.get(0);
+    GameState game;
+    game.reset(cueStart.x, cueStart.y);
+
+    std::vector<int> pocketed;
+    int shots = 0;
+    for (; shots < opt.maxShots && !game.over(); ++shots) {
+        Turn turn{sim, scratch, rng, opt.exact, odds};
+        Shot s = seat[game.player() - 1]->choose(turn);
+
+        game.beginShot();
+        balls.setVelocity(s.ball, std::cos(s.angle) * s.power, std::sin(s.angle) * s.power);
+        pocketed.clear();
+        if (opt.exact) {
+            EventSimulation events(sim);
+            events.simulateUntilRest(&pocketed);
+            balls = events.balls();
+        } else {
+            sim.simulateUntilRest(&pocketed);
+        }
+        for (int number : pocketed)
+            game.onPocket(number);
+
+        ShotResult r = game.endShot();
+        if (r.respotCue && balls.find(0) < 0)
+            balls.push({game.cueStartX(), game.cueStartY(), 0.f, 0.f, cueStart.radius, 0});
+        tally.scratches += r.scratch;
+        if (shots == 0) {
+            tally.breakBalls += r.scored;
+            tally.breaksScored += r.scored > 0;
+            tally.breakScratches += r.scratch;
+        }
+    }
+
+    ++tally.games;
+    tally.shots += shots;
+    if (game.winner() == 0)
+        ++tally.draws;
+    else
+        ++tally.wins[(game.winner() - 1) ^ (swapped ? 1 : 0)];
+}
+
+void usage() {
+    std::fprintf(stderr, "usage: tournament [--games N] [--threads T] [--p1 NAME] [--p2 NAME]\n"
+                         "                  [--seed S] [--max-shots N] [--events] [--table FILE]\n"
+                         "                  [--profile NAME]\n"
+                         "policies:");
+    for (const PolicyEntry& p : kPolicies)
+        std::fprintf(stderr, " %s", p.name);
+    std::fprintf(stderr, "\n");
+}
+
+bool parse(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        const char* v = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (std::strcmp(a, "--events") == 0) {
+            opt.exact = true;
+            continue;
+        }
+        if (!v)
+            return false;
+        ++i;
+        if (std::strcmp(a, "--games") == 0)
+            opt.games = std::strtoull(v, nullptr, 10);
+        else if (std::strcmp(a, "--threads") == 0)
+            opt.threads = static_cast<unsigned>(std::atoi(v));
+        else if (std::strcmp(a, "--seed") == 0)
+            opt.seed = static_cast<unsigned>(std::strtoul(v, nullptr, 10));
+        else if (std::strcmp(a, "--max-shots") == 0)
+            opt.maxShots = std::atoi(v);
+        else if (std::strcmp(a, "--table") == 0)
+            opt.table = v;
+        else if (std::strcmp(a, "--profile") == 0 && findPhysicsProfile(v))
+            opt.profile = findPhysicsProfile(v);
+        else if (std::strcmp(a, "--p1") == 0 && findPolicy(v))
+            opt.p1 = findPolicy(v);
+        else if (std::strcmp(a, "--p2") == 0 && findPolicy(v))
+            opt.p2 = findPolicy(v);
+        else
+            return false;
+    }
+    return opt.games > 0 && opt.maxShots > 0;
+}
+
+double percent(std::uint64_t part, std::uint64_t whole) {
+    return whole ? 100.0 * part / whole : 0.0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parse(argc, argv, opt)) {
+        usage();
+        return 2;
+    }
+
+    TableLayout layout;
+    ShotTable odds;
+    const bool needsTable = std::strcmp(opt.p1->name, "table") == 0 || std::strcmp(opt.p2->name, "table") == 0;
+    if ((needsTable || !opt.table.empty()) && !odds.open(opt.table.empty() ? "cache/shot_table.bin" : opt.table, layout,
+                                                     opt.profile->params)) {
+        std::fprintf(stderr, "%s\n", odds.error().c_str());
+        return 1;
+    }
+    WorkStealingPool pool(opt.threads ? opt.threads : std::thread::hardware_concurrency());
+    const TableGeometry geometry = layout.geometry();
+    Simulation prototype(geometry);
+    prototype.setProfile(opt.profile->name);
+    std::vector<Simulation> tables(pool.size(), prototype);
+    std::vector<Simulation> scratch(pool.size(), prototype);
+    std::vector<Tally> tallies(pool.size());
+
+    auto t0 = std::chrono::steady_clock::now();
+    pool.parallelFor(opt.games, [&](std::size_t g, unsigned worker) {
+        playGame(layout, opt, odds, g, tables[worker], scratch[worker], tallies[worker]);
+    });
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    Tally total;
+    for (const Tally& t : tallies)
+        total.add(t);
+    const double n = static_cast<double>(total.games);
+
+    std::printf("%llu games, %u threads, %s physics, %s profile, %.2f s\n",
+                static_cast<unsigned long long>(total.games), pool.size(),
+                opt.exact ? "event" : "fixed-step", opt.profile->name, sec);
+    std::printf("throughput  %.0f games/s, %.1f games/s per core\n", n / sec, n / sec / pool.size());
+    std::printf("p1 %-8s wins %5.1f%%\n", opt.p1->name, percent(total.wins[0], total.games));
+    std::printf("p2 %-8s wins %5.1f%%\n", opt.p2->name, percent(total.wins[1], total.games));
+    std::printf("draws (%d shots) %5.1f%%\n", opt.maxShots, percent(total.draws, total.games));
+    std::printf("shots/game  %.1f, scratches/game %.2f\n", total.shots / n, total.scratches / n);
+    std::printf("break       %.2f balls, %.1f%% pocket at least one, %.1f%% scratch\n",
+                total.breakBalls / n, percent(total.breaksScored, total.games),
+                percent(total.breakScratches, total.games));
+    return 0;
+}